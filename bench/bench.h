@@ -0,0 +1,160 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Headless benchmarks
+//   Every scene is rendered for BENCH_WARMUP + frames frames into a hidden window
+//   with vsync off. One JSON object per scene is written to stdout:
+//
+//   {"bench":"solid_rect","primitives":100000,"frames":256,"cpu_ns_per_frame":..,
+//    "cpu_ns_min_frame":..,"cpu_ns_per_primitive":..,"draw_calls":..,"verticies":..,
+//    "bytes_uploaded":..,"texture_binds":..,"uniform_updates":..,"text_run_hit_rate":..}
+//
+//   The cpu time covers building the scene and submitting it (frame_renderer_end),
+//   but not SwapBuffers. Counters are averages per frame, the hit rate is over all
+//   lookups of the text run cache (0 without text).
+//
+//   bench.exe [frames] [font]
+//
+//   q stops the run, the scene it was in and the ones after it are not reported.
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "../thirdparty/stb_truetype.h"
+
+#define FRAME_IMPLEMENTATION
+#define FRAME_STB_TRUETYPE
+#define FRAME_STATS
+#include "../src/frame.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_WIDTH 1280
+#define BENCH_HEIGHT 720
+#define BENCH_WARMUP 16
+#define BENCH_FRAMES 256
+#define BENCH_FONT "C:\\windows\\Fonts\\arial.ttf"
+#define BENCH_FONT_HEIGHT 64.0f
+
+typedef void (*Bench_Scene)(void *arg, int frame);
+
+typedef struct{
+  Frame frame;
+  int frames;
+  const char *font;
+}Bench;
+
+static bool bench_init(Bench *b, const char *title, int argc, char **argv) {
+  b->frames = BENCH_FRAMES;
+  b->font = BENCH_FONT;
+  if(argc > 1) {
+    b->frames = atoi(argv[1]);
+    if(b->frames <= 0) {
+      b->frames = BENCH_FRAMES;
+    }
+  }
+  if(argc > 2) {
+    b->font = argv[2];
+  }
+
+  if(!frame_init(&b->frame, BENCH_WIDTH, BENCH_HEIGHT, title, FRAME_NOT_RESIZABLE | FRAME_HIDDEN)) {
+    fprintf(stderr, "ERROR: Can not open window\n");
+    return false;
+  }
+
+  if(!frame_set_vsync(&b->frame, false)) {
+    fprintf(stderr, "WARNING: Can not disable vsync\n");
+  }
+
+  return true;
+}
+
+static bool bench_push_font(Bench *b) {
+  unsigned int font;
+  if(!push_font(b->font, BENCH_FONT_HEIGHT, &font)) {
+    fprintf(stderr, "ERROR: Can not load font: %s\n", b->font);
+    return false;
+  }
+  return true;
+}
+
+// Same sequence on every run
+static float bench_random(unsigned int *seed) {
+  *seed = *seed * 1664525u + 1013904223u;
+  return (float) (*seed >> 8) / (float) (1u << 24);
+}
+
+static Frame_Renderer_Vec4f bench_random_color(unsigned int *seed) {
+  return vec4f(bench_random(seed), bench_random(seed), bench_random(seed), 1.0f);
+}
+
+static void bench_run(Bench *b, const char *name, int primitives, Bench_Scene scene, void *arg) {
+
+  Frame_Event event;
+  Frame_Renderer_Stats stats;
+  Frame_Renderer_Stats sum = {0};
+  LARGE_INTEGER frequency, start, end;
+  QueryPerformanceFrequency(&frequency);
+
+  double total_ns = 0.0;
+  double min_ns = -1.0;
+
+  // one more frame, the counters of a frame are committed in the next frame_renderer_begin
+  int count = BENCH_WARMUP + b->frames + 1;
+  for(int i=0;i<count;i++) {
+    while(frame_peek(&b->frame, &event)) {
+      if(event.type == FRAME_EVENT_KEYPRESS && event.as.key == 'q') {
+	b->frame.running = false;
+      }
+    }
+    // quit or closed, the scene is not reported
+    if(!b->frame.running) {
+      return;
+    }
+
+    if(i > BENCH_WARMUP && frame_renderer_stats(&stats)) {
+      sum.draw_calls += stats.draw_calls;
+      sum.verticies += stats.verticies;
+      sum.bytes_uploaded += stats.bytes_uploaded;
+      sum.texture_binds += stats.texture_binds;
+      sum.uniform_updates += stats.uniform_updates;
+      sum.text_runs += stats.text_runs;
+      sum.text_run_hits += stats.text_run_hits;
+    }
+    if(i == count - 1) {
+      break;
+    }
+
+    QueryPerformanceCounter(&start);
+    scene(arg, i);
+    frame_renderer_end();
+    QueryPerformanceCounter(&end);
+
+    if(i >= BENCH_WARMUP) {
+      double ns = (double) (end.QuadPart - start.QuadPart) * 1000000000.0 / (double) frequency.QuadPart;
+      total_ns += ns;
+      if(min_ns < 0.0 || ns < min_ns) {
+	min_ns = ns;
+      }
+    }
+
+    frame_swap_buffers(&b->frame);
+  }
+
+  double frames = (double) b->frames;
+  printf("{\"bench\":\"%s\",\"primitives\":%d,\"frames\":%d,"
+	 "\"cpu_ns_per_frame\":%.0f,\"cpu_ns_min_frame\":%.0f,\"cpu_ns_per_primitive\":%.2f,"
+	 "\"draw_calls\":%.1f,\"verticies\":%.1f,\"bytes_uploaded\":%.0f,"
+	 "\"texture_binds\":%.1f,\"uniform_updates\":%.1f,\"text_run_hit_rate\":%.3f}\n",
+	 name, primitives, b->frames,
+	 total_ns / frames, min_ns, total_ns / frames / (double) (primitives > 0 ? primitives : 1),
+	 (double) sum.draw_calls / frames, (double) sum.verticies / frames, (double) sum.bytes_uploaded / frames,
+	 (double) sum.texture_binds / frames, (double) sum.uniform_updates / frames,
+	 (double) sum.text_run_hits / (double) (sum.text_runs > 0 ? sum.text_runs : 1));
+  fflush(stdout);
+}
+
+static void bench_free(Bench *b) {
+  frame_free(&b->frame);
+}
+
+#endif //BENCH_H
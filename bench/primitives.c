@@ -0,0 +1,120 @@
+#include "bench.h"
+
+#define RECTS_COUNT 100000
+#define CIRCLES_COUNT 10000
+#define ROUNDED_COUNT 10000
+#define TEXTURES_COUNT 10000
+
+#define TEXTURE_SIZE 64
+
+typedef struct{
+  int count;
+  int parts;
+  unsigned int textures[2];
+  int textures_count;
+}Scene;
+
+static void scene_solid_rect(void *arg, int frame) {
+  Scene *s = (Scene *) arg;
+  (void) frame;
+
+  unsigned int seed = 1;
+  for(int i=0;i<s->count;i++) {
+    Vec2f p = vec2f(bench_random(&seed) * BENCH_WIDTH, bench_random(&seed) * BENCH_HEIGHT);
+    draw_solid_rect(p, vec2f(8, 8), bench_random_color(&seed));
+  }
+}
+
+static void scene_solid_circle(void *arg, int frame) {
+  Scene *s = (Scene *) arg;
+  (void) frame;
+
+  unsigned int seed = 2;
+  for(int i=0;i<s->count;i++) {
+    Vec2f p = vec2f(bench_random(&seed) * BENCH_WIDTH, bench_random(&seed) * BENCH_HEIGHT);
+    draw_solid_circle(p, 0, 2 * PI, 6.0f, s->parts, bench_random_color(&seed));
+  }
+}
+
+static void scene_rounded_rect(void *arg, int frame) {
+  Scene *s = (Scene *) arg;
+  (void) frame;
+
+  unsigned int seed = 3;
+  for(int i=0;i<s->count;i++) {
+    Vec2f p = vec2f(bench_random(&seed) * BENCH_WIDTH, bench_random(&seed) * BENCH_HEIGHT);
+    draw_solid_rounded_rect(p, vec2f(48, 24), 6.0f, s->parts, bench_random_color(&seed));
+  }
+}
+
+static void scene_rounded_shaded_rect(void *arg, int frame) {
+  Scene *s = (Scene *) arg;
+  (void) frame;
+
+  unsigned int seed = 4;
+  for(int i=0;i<s->count;i++) {
+    Vec2f p = vec2f(bench_random(&seed) * BENCH_WIDTH, bench_random(&seed) * BENCH_HEIGHT);
+    draw_solid_rounded_shaded_rect(p, vec2f(48, 24), 6.0f, s->parts, 2.0f, bench_random_color(&seed));
+  }
+}
+
+static void scene_texture(void *arg, int frame) {
+  Scene *s = (Scene *) arg;
+  (void) frame;
+
+  unsigned int seed = 5;
+  for(int i=0;i<s->count;i++) {
+    Vec2f p = vec2f(bench_random(&seed) * BENCH_WIDTH, bench_random(&seed) * BENCH_HEIGHT);
+    draw_texture(s->textures[i % s->textures_count], p, vec2f(32, 32), vec2f(0, 0), vec2f(1, 1));
+  }
+}
+
+static bool push_checker(unsigned int color, unsigned int *index) {
+  static unsigned int data[TEXTURE_SIZE * TEXTURE_SIZE];
+  for(int y=0;y<TEXTURE_SIZE;y++) {
+    for(int x=0;x<TEXTURE_SIZE;x++) {
+      data[y * TEXTURE_SIZE + x] = ((x / 8 + y / 8) % 2) ? color : 0xffffffff;
+    }
+  }
+  return push_texture(TEXTURE_SIZE, TEXTURE_SIZE, data, false, index);
+}
+
+int main(int argc, char **argv) {
+
+  Bench bench;
+  if(!bench_init(&bench, "Bench Primitives", argc, argv)) {
+    return 1;
+  }
+
+  Scene scene = {0};
+  if(!push_checker(0xff0000ff, &scene.textures[0]) ||
+     !push_checker(0xffff0000, &scene.textures[1])) {
+    return 1;
+  }
+
+  scene.count = RECTS_COUNT;
+  bench_run(&bench, "solid_rect", scene.count, scene_solid_rect, &scene);
+
+  int parts[] = {8, 20, 64};
+  char name[64];
+  for(size_t i=0;i<sizeof(parts)/sizeof(parts[0]);i++) {
+    scene.count = CIRCLES_COUNT;
+    scene.parts = parts[i];
+    snprintf(name, sizeof(name), "solid_circle_%d", scene.parts);
+    bench_run(&bench, name, scene.count, scene_solid_circle, &scene);
+  }
+
+  scene.count = ROUNDED_COUNT;
+  scene.parts = 10;
+  bench_run(&bench, "solid_rounded_rect", scene.count, scene_rounded_rect, &scene);
+  bench_run(&bench, "solid_rounded_shaded_rect", scene.count, scene_rounded_shaded_rect, &scene);
+
+  scene.count = TEXTURES_COUNT;
+  scene.textures_count = 1;
+  bench_run(&bench, "texture", scene.count, scene_texture, &scene);
+  scene.textures_count = 2;
+  bench_run(&bench, "texture_switch", scene.count, scene_texture, &scene);
+
+  bench_free(&bench);
+  return 0;
+}
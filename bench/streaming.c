@@ -0,0 +1,148 @@
+#include "bench.h"
+
+// 1080p frames from a source running at 60 Hz, pushed with push_to_texture and
+// through a stream. A source frame is dropped when it is not pushed before the next
+// one is due, or when the stream has no free buffer. The upload time does not include
+// writing the pixels.
+//
+//   {"bench":"video_stream","width":1920,"height":1080,"source_frames":256,"dropped":..,
+//    "upload_ms_avg":..,"upload_ms_max":..,"frame_ms_avg":..}
+
+#define VIDEO_WIDTH 1920
+#define VIDEO_HEIGHT 1080
+#define VIDEO_HZ 60
+
+typedef struct{
+  unsigned int texture;
+  bool stream;
+  unsigned int *pixels; // for push_to_texture
+}Video;
+
+// moving gradient, every pixel changes
+static void video_fill(unsigned int *pixels, int frame) {
+  for(int y=0;y<VIDEO_HEIGHT;y++) {
+    unsigned int *row = pixels + (size_t) y * VIDEO_WIDTH;
+    unsigned int g = (unsigned int) (y + frame) & 0xff;
+    for(int x=0;x<VIDEO_WIDTH;x++) {
+      unsigned int r = (unsigned int) (x + frame) & 0xff;
+      row[x] = 0xff000000 | (g << 8) | r;
+    }
+  }
+}
+
+static double video_ms(LARGE_INTEGER a, LARGE_INTEGER b, LARGE_INTEGER frequency) {
+  return (double) (b.QuadPart - a.QuadPart) * 1000.0 / (double) frequency.QuadPart;
+}
+
+static void video_run(Bench *b, const char *name, Video *v) {
+
+  Frame_Event event;
+  LARGE_INTEGER frequency, start, now, t0, t1, t2, t3;
+  QueryPerformanceFrequency(&frequency);
+  double period = (double) frequency.QuadPart / (double) VIDEO_HZ;
+
+  int source_frames = BENCH_WARMUP + b->frames;
+  int dropped = 0;
+  int uploads = 0;
+  int frames = 0;
+  double upload_ms = 0.0;
+  double upload_ms_max = 0.0;
+  double frame_ms = 0.0;
+
+  QueryPerformanceCounter(&start);
+  int last = -1;
+  while(b->frame.running) {
+    while(frame_peek(&b->frame, &event)) {
+      if(event.type == FRAME_EVENT_KEYPRESS && event.as.key == 'q') {
+	b->frame.running = false;
+      }
+    }
+
+    QueryPerformanceCounter(&now);
+    int due = (int) ((double) (now.QuadPart - start.QuadPart) / period);
+    if(due >= source_frames) {
+      break;
+    }
+    bool measure = due >= BENCH_WARMUP;
+
+    if(due > last) {
+      if(measure) {
+	dropped += due - last - 1;
+      }
+      last = due;
+
+      bool pushed;
+      QueryPerformanceCounter(&t0);
+      if(v->stream) {
+	void *pixels;
+	pushed = stream_map(v->texture, &pixels);
+	QueryPerformanceCounter(&t1);
+	if(pushed) {
+	  video_fill((unsigned int *) pixels, due);
+	}
+	QueryPerformanceCounter(&t2);
+	pushed = pushed && stream_commit(v->texture);
+      } else {
+	t1 = t0;
+	video_fill(v->pixels, due);
+	QueryPerformanceCounter(&t2);
+	pushed = frame_renderer_push_to_texture(v->texture, v->pixels, 0, 0, VIDEO_WIDTH, VIDEO_HEIGHT);
+      }
+      QueryPerformanceCounter(&t3);
+
+      if(measure) {
+	double ms = video_ms(t0, t1, frequency) + video_ms(t2, t3, frequency);
+	upload_ms += ms;
+	if(ms > upload_ms_max) upload_ms_max = ms;
+	uploads++;
+	if(!pushed) dropped++;
+      }
+    }
+
+    draw_texture(v->texture, vec2f(0, 0), vec2f(BENCH_WIDTH, BENCH_HEIGHT), vec2f(0, 0), vec2f(1, 1));
+    frame_swap_buffers(&b->frame);
+
+    if(measure) {
+      frame_ms += b->frame.dt;
+      frames++;
+    }
+  }
+
+  printf("{\"bench\":\"%s\",\"width\":%d,\"height\":%d,\"source_frames\":%d,\"dropped\":%d,"
+	 "\"upload_ms_avg\":%.3f,\"upload_ms_max\":%.3f,\"frame_ms_avg\":%.3f}\n",
+	 name, VIDEO_WIDTH, VIDEO_HEIGHT, b->frames, dropped,
+	 upload_ms / (double) (uploads > 0 ? uploads : 1), upload_ms_max,
+	 frame_ms / (double) (frames > 0 ? frames : 1));
+  fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+
+  Bench bench;
+  if(!bench_init(&bench, "Bench Streaming", argc, argv)) {
+    return 1;
+  }
+
+  Video video = {0};
+  video.pixels = (unsigned int *) malloc((size_t) VIDEO_WIDTH * VIDEO_HEIGHT * 4);
+  if(!video.pixels) {
+    return 1;
+  }
+
+  if(!frame_renderer_create_texture(VIDEO_WIDTH, VIDEO_HEIGHT, &video.texture)) {
+    return 1;
+  }
+  video_run(&bench, "video_push_to_texture", &video);
+  release_texture(video.texture);
+
+  if(!create_stream(VIDEO_WIDTH, VIDEO_HEIGHT, &video.texture)) {
+    return 1;
+  }
+  video.stream = true;
+  video_run(&bench, "video_stream", &video);
+  release_texture(video.texture);
+
+  free(video.pixels);
+  bench_free(&bench);
+  return 0;
+}
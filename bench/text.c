@@ -0,0 +1,102 @@
+#include "bench.h"
+
+#define PAGE_LINES 40
+#define WRAPPED_COUNT 8
+
+// sizes of the bake, besides BENCH_FONT_HEIGHT
+static const float bake_heights[] = {14.0f, 18.0f, 24.0f, 32.0f, 48.0f};
+
+static const char *lorem =
+  "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor "
+  "incididunt ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud "
+  "exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat. Duis aute irure "
+  "dolor in reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla pariatur.";
+
+typedef struct{
+  const char *text;
+  size_t text_len;
+  int lines;
+  float scale;
+}Scene;
+
+static void scene_text(void *arg, int frame) {
+  Scene *s = (Scene *) arg;
+  (void) frame;
+
+  float line_height = BENCH_FONT_HEIGHT * s->scale;
+  for(int i=0;i<s->lines;i++) {
+    size_t off = (size_t) (i * 7) % (s->text_len / 2);
+    draw_text_len_colored(s->text + off, s->text_len - off,
+			  vec2f(0, BENCH_HEIGHT - (float) (i + 1) * line_height),
+			  s->scale, WHITE);
+  }
+}
+
+static void scene_text_wrapped(void *arg, int frame) {
+  Scene *s = (Scene *) arg;
+  (void) frame;
+
+  float column = (float) BENCH_WIDTH / WRAPPED_COUNT;
+  for(int i=0;i<WRAPPED_COUNT;i++) {
+    Vec2f pos = vec2f(i * column, BENCH_HEIGHT - BENCH_FONT_HEIGHT * s->scale);
+    draw_text_wrapped(s->text, s->text_len, &pos, vec2f(column, BENCH_HEIGHT), s->scale, WHITE);
+  }
+}
+
+// Startup cost of a font in several sizes, glyphs are ASCII 32..127:
+//   {"bench":"font_bake","glyphs":..,"ms":..}
+static bool bench_font_bake(Bench *b) {
+  int count = (int) (sizeof(bake_heights) / sizeof(bake_heights[0]));
+  double total = 0.0;
+  for(int i=0;i<count;i++) {
+    unsigned int font;
+    double ms;
+    if(!push_font(b->font, bake_heights[i], &font) || !bake_font(font, 32, 96, &ms)) {
+      fprintf(stderr, "ERROR: Can not bake font: %s\n", b->font);
+      return false;
+    }
+    total += ms;
+  }
+
+  printf("{\"bench\":\"font_bake\",\"glyphs\":%d,\"ms\":%.3f}\n", count * 96, total);
+  fflush(stdout);
+  return true;
+}
+
+int main(int argc, char **argv) {
+
+  Bench bench;
+  if(!bench_init(&bench, "Bench Text", argc, argv)) {
+    return 1;
+  }
+  if(!bench_font_bake(&bench) || !bench_push_font(&bench)) {
+    return 1;
+  }
+
+  Scene scene = {0};
+  scene.text = lorem;
+  scene.text_len = strlen(lorem);
+
+  // primitives are glyphs
+  int glyphs = 0;
+  scene.lines = PAGE_LINES;
+  scene.scale = .25f;
+  for(int i=0;i<scene.lines;i++) {
+    glyphs += (int) (scene.text_len - (size_t) (i * 7) % (scene.text_len / 2));
+  }
+  bench_run(&bench, "text_page", glyphs, scene_text, &scene);
+
+  scene.scale = .5f;
+  scene.lines = PAGE_LINES / 2;
+  glyphs = 0;
+  for(int i=0;i<scene.lines;i++) {
+    glyphs += (int) (scene.text_len - (size_t) (i * 7) % (scene.text_len / 2));
+  }
+  bench_run(&bench, "text_page_large", glyphs, scene_text, &scene);
+
+  scene.scale = .25f;
+  bench_run(&bench, "text_wrapped", (int) scene.text_len * WRAPPED_COUNT, scene_text_wrapped, &scene);
+
+  bench_free(&bench);
+  return 0;
+}
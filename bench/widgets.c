@@ -0,0 +1,68 @@
+#include "bench.h"
+
+#define GRID_COLUMNS 20
+#define GRID_ROWS 30
+
+typedef struct{
+  float values[GRID_COLUMNS * GRID_ROWS];
+  bool text;
+}Scene;
+
+static void scene_buttons(void *arg, int frame) {
+  Scene *s = (Scene *) arg;
+  (void) frame;
+
+  Vec2f cell = vec2f((float) BENCH_WIDTH / GRID_COLUMNS, (float) BENCH_HEIGHT / GRID_ROWS);
+  Vec2f size = vec2f(cell.x - 4, cell.y - 4);
+  for(int y=0;y<GRID_ROWS;y++) {
+    for(int x=0;x<GRID_COLUMNS;x++) {
+      Vec2f p = vec2f(x * cell.x + 2, y * cell.y + 2);
+      if(s->text) {
+	frame_renderer_text_button("Button", 6, .25f, WHITE, p, size, vec4f(.2f, .2f, .2f, 1));
+      } else {
+	button(p, size, vec4f(.2f, .2f, .2f, 1));
+      }
+    }
+  }
+}
+
+static void scene_sliders(void *arg, int frame) {
+  Scene *s = (Scene *) arg;
+  (void) frame;
+
+  Vec2f cell = vec2f((float) BENCH_WIDTH / GRID_COLUMNS, (float) BENCH_HEIGHT / GRID_ROWS);
+  for(int y=0;y<GRID_ROWS;y++) {
+    for(int x=0;x<GRID_COLUMNS;x++) {
+      float *value = &s->values[y * GRID_COLUMNS + x];
+      frame_renderer_slider(vec2f(x * cell.x + 8, y * cell.y + cell.y / 2 - 2),
+			    vec2f(cell.x - 16, 4),
+			    vec4f(.9f, .4f, .1f, 1), vec4f(.3f, .3f, .3f, 1),
+			    *value, value);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+
+  Bench bench;
+  if(!bench_init(&bench, "Bench Widgets", argc, argv)) {
+    return 1;
+  }
+  if(!bench_push_font(&bench)) {
+    return 1;
+  }
+
+  Scene scene = {0};
+  unsigned int seed = 6;
+  for(int i=0;i<GRID_COLUMNS * GRID_ROWS;i++) {
+    scene.values[i] = bench_random(&seed);
+  }
+
+  bench_run(&bench, "button_grid", GRID_COLUMNS * GRID_ROWS, scene_buttons, &scene);
+  scene.text = true;
+  bench_run(&bench, "text_button_grid", GRID_COLUMNS * GRID_ROWS, scene_buttons, &scene);
+  bench_run(&bench, "slider_grid", GRID_COLUMNS * GRID_ROWS, scene_sliders, &scene);
+
+  bench_free(&bench);
+  return 0;
+}
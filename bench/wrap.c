@@ -0,0 +1,157 @@
+#include "bench.h"
+
+// Word wrapping of 1 MB of text into a column, every frame. The text is read from a
+// file, or else made of paragraphs of lorem ipsum. Primitives are bytes.
+//
+// The view scenes draw a screen of a text view holding 1 KB and all of the text, which
+// should take the same time, and append WRAP_APPEND_SIZE bytes every frame.
+//
+//   wrap.exe [frames] [font] [text file]
+
+#define WRAP_TEXT_SIZE (1024 * 1024)
+#define WRAP_SCALE .25f
+#define WRAP_APPEND_SIZE 4096
+
+static const char *lorem =
+  "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor "
+  "incididunt ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud "
+  "exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat. Duis aute irure "
+  "dolor in reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla pariatur.";
+
+typedef struct{
+  char *text;
+  size_t text_len;
+  float column;
+  bool draw;
+  Frame_Renderer_Text_Layout layout;
+  Frame_Renderer_Text_View view;
+  size_t appended;
+  bool append;
+}Scene;
+
+static bool wrap_read_text(const char *path, Scene *s) {
+  Frame_Renderer_File_Map map;
+  if(!frame_renderer_file_map(path, &map)) {
+    return false;
+  }
+
+  s->text = (char *) malloc(map.size);
+  if(s->text) {
+    memcpy(s->text, map.view, map.size);
+    s->text_len = map.size;
+  }
+  frame_renderer_file_unmap(&map);
+  return s->text != NULL;
+}
+
+static bool wrap_make_text(Scene *s) {
+  s->text = (char *) malloc(WRAP_TEXT_SIZE);
+  if(!s->text) {
+    return false;
+  }
+
+  size_t lorem_len = strlen(lorem);
+  int sentences = 0;
+  while(s->text_len + lorem_len + 2 <= WRAP_TEXT_SIZE) {
+    memcpy(s->text + s->text_len, lorem, lorem_len);
+    s->text_len += lorem_len;
+    // paragraphs of four
+    s->text[s->text_len++] = ++sentences % 4 == 0 ? '\n' : ' ';
+  }
+  return true;
+}
+
+static void scene_wrap(void *arg, int frame) {
+  Scene *s = (Scene *) arg;
+  (void) frame;
+
+  if(!frame_renderer_layout_text(s->text, s->text_len, s->column, WRAP_SCALE, &s->layout)) {
+    return;
+  }
+  if(!s->draw) {
+    return;
+  }
+
+  // the lines on the screen
+  Frame_Renderer_Text_Layout visible = s->layout;
+  int lines = (int) (BENCH_HEIGHT / visible.line_height);
+  if(visible.lines_count > lines) {
+    visible.lines_count = lines;
+  }
+  draw_text_layout(&visible, s->text, vec2f(0, BENCH_HEIGHT - visible.line_height), WHITE);
+}
+
+static void scene_view(void *arg, int frame) {
+  Scene *s = (Scene *) arg;
+  (void) frame;
+
+  if(s->append) {
+    size_t at = s->appended % s->text_len;
+    size_t n = s->text_len - at < WRAP_APPEND_SIZE ? s->text_len - at : WRAP_APPEND_SIZE;
+    frame_renderer_text_view_append(&s->view, s->text + at, n);
+    s->appended += n;
+  }
+
+  // the last screen
+  double height = (double) s->view.lines_count * s->view.line_height;
+  double scroll = height > BENCH_HEIGHT ? height - BENCH_HEIGHT : 0;
+  draw_text_view(&s->view, vec2f(0, 0), vec2f(s->column, BENCH_HEIGHT), scroll, WHITE);
+}
+
+static bool wrap_view(Scene *s, size_t text_len) {
+  frame_renderer_text_view_free(&s->view);
+  if(!frame_renderer_text_view_init(&s->view, (unsigned int) frame_renderer.font_current, s->column, WRAP_SCALE)) {
+    return false;
+  }
+  return frame_renderer_text_view_append(&s->view, s->text, text_len);
+}
+
+int main(int argc, char **argv) {
+
+  Bench bench;
+  if(!bench_init(&bench, "Bench Wrap", argc, argv)) {
+    return 1;
+  }
+  if(!bench_push_font(&bench)) {
+    return 1;
+  }
+
+  Scene scene = {0};
+  if(argc > 3) {
+    if(!wrap_read_text(argv[3], &scene)) {
+      fprintf(stderr, "ERROR: Can not read file: %s\n", argv[3]);
+      return 1;
+    }
+  } else if(!wrap_make_text(&scene)) {
+    return 1;
+  }
+
+  scene.column = BENCH_WIDTH / 2;
+  bench_run(&bench, "wrap_layout", (int) scene.text_len, scene_wrap, &scene);
+
+  scene.draw = true;
+  bench_run(&bench, "wrap_layout_draw", (int) scene.text_len, scene_wrap, &scene);
+
+  scene.column = BENCH_WIDTH / 8;
+  bench_run(&bench, "wrap_layout_narrow", (int) scene.text_len, scene_wrap, &scene);
+
+  scene.column = BENCH_WIDTH / 2;
+  if(!wrap_view(&scene, scene.text_len < 1024 ? scene.text_len : 1024)) {
+    return 1;
+  }
+  bench_run(&bench, "view_draw_1k", 1024, scene_view, &scene);
+
+  if(!wrap_view(&scene, scene.text_len)) {
+    return 1;
+  }
+  bench_run(&bench, "view_draw", (int) scene.text_len, scene_view, &scene);
+
+  scene.append = true;
+  bench_run(&bench, "view_append", WRAP_APPEND_SIZE, scene_view, &scene);
+
+  frame_renderer_text_view_free(&scene.view);
+  frame_renderer_text_layout_free(&scene.layout);
+  free(scene.text);
+  bench_free(&bench);
+  return 0;
+}
@@ -25,7 +25,8 @@ int main() {
 
 #define FONT_SIZE 64
 
-    if(!push_font("c:\\windows\\fonts\\segoeui.ttf", FONT_SIZE)) {
+    unsigned int font;
+    if(!push_font("c:\\windows\\fonts\\segoeui.ttf", FONT_SIZE, &font)) {
 	return 1;
     }
 
@@ -8,6 +8,7 @@
 #define FRAME_IMPLEMENTATION
 #define FRAME_STB_IMAGE
 #define FRAME_STB_TRUETYPE
+#define FRAME_GPU_TIMER
 #include "../src/frame.h"
 
 #include <stdint.h>
@@ -28,13 +29,17 @@ int main() {
   }
 
   /*
+  // tools/embed.c: embed.exe rsc\logo.jpg rsc\logo.h logo
   #include "../rsc/logo.h"
+  logo_width = LOGO_WIDTH;
+  logo_height = LOGO_HEIGHT;
   if(!push_texture(logo_width, logo_height, logo_data, false, &tex)) {
       return 1;
   }
   */
 
-  if(!push_font("C:\\windows\\Fonts\\arial.ttf", 64.0)) {
+  unsigned int font;
+  if(!push_font("C:\\windows\\Fonts\\arial.ttf", 64.0, &font)) {
       return 1;
   }
 
@@ -104,6 +109,8 @@ int main() {
     snprintf(buf, sizeof(buf), "%.2f ms", frame.dt);
     draw_text(buf, vec2f(0, heightf - 64.0f * .5f * 2), .5f );
 
+    frame_renderer_gpu_overlay(vec2f(0, heightf - 64.0f * .5f * 3), 1.0f);
+
     draw_solid_circle(vec2f((float) mouse_x, (float) mouse_y),
 		      0,
 		      2 * PI,
@@ -112,6 +119,13 @@ int main() {
 		      vec4f(1, 0, 0, 1) );
 
     draw_solid_rect_angle( vec2f(widthf/2 - 50, heightf/2 - 50), vec2f(100, 100), time * 6 / 4 * PI / 1000 , vec4f(1, 0, 0, .4) );
+
+    path_begin();
+    path_move_to(vec2f(widthf - 60, 20));
+    path_cubic_to(vec2f(widthf - 110, 60), vec2f(widthf - 90, 100), vec2f(widthf - 60, 80));
+    path_cubic_to(vec2f(widthf - 30, 100), vec2f(widthf - 10, 60), vec2f(widthf - 60, 20));
+    path_close();
+    draw_path(FRAME_RENDERER_FILL_NONZERO, vec4f(1, 0, 1, .8));
 	    
     frame_swap_buffers(&frame);
 
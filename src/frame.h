@@ -20,6 +20,11 @@
 #include <windows.h>
 #include <GL/GL.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define FRAME_SSE2
+#  include <emmintrin.h>
+#endif
+
 #ifndef FRAME_DEF
 #  define FRAME_DEF static inline
 #endif //FRAME_DEF
@@ -89,6 +94,7 @@ typedef struct{
 #define FRAME_NOT_RESIZABLE 0x2
 #define FRAME_DRAG_N_DROP   0x4
 #define FRAME_FULLSCREEN    0x8
+#define FRAME_HIDDEN        0x10 // never shown, for headless runs
 
 FRAME_DEF bool frame_init(Frame *w, int width, int height, const char *title, int flags);
 FRAME_DEF bool frame_set_vsync(Frame *w, bool use_vsync);
@@ -111,6 +117,64 @@ FRAME_DEF void frame_clipboard_free(Frame_Clipboard *clipboard);
 FRAME_DEF bool frame_compile_shader(GLuint *shader, GLenum shader_type, const char *shader_source);
 FRAME_DEF bool frame_link_program(GLuint *program, GLuint vertex_shader, GLuint fragment_shader);
 
+// Tracing
+//   Zones are recorded into a ring per thread, without locks, and written as
+//   Chrome Trace Event JSON (chrome://tracing, ui.perfetto.dev) by frame_trace_dump.
+//
+//   FRAME_TRACE_ZONE("name") {
+//     ...
+//   }
+//
+//   Leaving the block with break or return skips the end of the zone, use
+//   FRAME_TRACE_BEGIN / FRAME_TRACE_END in that case.
+#ifdef FRAME_TRACE
+
+#define FRAME_TRACE_CAP (1 << 16) // events per thread, a power of two
+#define FRAME_TRACE_DEPTH 64
+
+typedef struct{
+  const char *name;
+  LONGLONG begin, end;
+}Frame_Trace_Event;
+
+typedef struct Frame_Trace_Buffer Frame_Trace_Buffer;
+
+struct Frame_Trace_Buffer{
+  Frame_Trace_Event events[FRAME_TRACE_CAP];
+  volatile DWORD head; // events written so far, wraps around, only the owning thread writes
+  volatile LONG full; // set once head went past FRAME_TRACE_CAP
+
+  DWORD thread_id;
+  const char *stack_names[FRAME_TRACE_DEPTH];
+  LONGLONG stack_begins[FRAME_TRACE_DEPTH];
+  int depth;
+
+  Frame_Trace_Buffer *next;
+};
+
+FRAME_DEF void frame_trace_begin(const char *name);
+FRAME_DEF void frame_trace_end();
+FRAME_DEF bool frame_trace_dump(const char *filepath);
+// Frees the buffers of all threads. No other thread may trace meanwhile,
+// threads that trace afterwards start with a new buffer.
+FRAME_DEF void frame_trace_free();
+
+#  define FRAME_TRACE_CONCAT_IMPL(a, b) a##b
+#  define FRAME_TRACE_CONCAT(a, b) FRAME_TRACE_CONCAT_IMPL(a, b)
+#  define FRAME_TRACE_BEGIN(name) frame_trace_begin((name))
+#  define FRAME_TRACE_END() frame_trace_end()
+#  define FRAME_TRACE_ZONE(name)					\
+  for(int FRAME_TRACE_CONCAT(frame_trace_zone_, __LINE__) = (frame_trace_begin((name)), 1); \
+      FRAME_TRACE_CONCAT(frame_trace_zone_, __LINE__);			\
+      FRAME_TRACE_CONCAT(frame_trace_zone_, __LINE__) = (frame_trace_end(), 0))
+#else
+#  define FRAME_TRACE_BEGIN(name)
+#  define FRAME_TRACE_END()
+#  define FRAME_TRACE_ZONE(name)
+#endif //FRAME_TRACE
+
+typedef struct __GLsync *GLsync; // opengl 3.2
+
 #ifndef FRAME_NO_RENDERER
 
 typedef struct{
@@ -137,21 +201,492 @@ typedef struct{
 
 #define FRAME_RENDERER_CAP (1024 * 4)
 
+typedef enum{
+  FRAME_RENDERER_FILL_NONZERO = 0,
+  FRAME_RENDERER_FILL_EVENODD,
+}Frame_Renderer_Fill_Rule;
+
+typedef enum{
+  FRAME_RENDERER_PATH_MOVE = 0,
+  FRAME_RENDERER_PATH_LINE,
+  FRAME_RENDERER_PATH_QUAD,
+  FRAME_RENDERER_PATH_CUBIC,
+  FRAME_RENDERER_PATH_CLOSE,
+}Frame_Renderer_Path_Type;
+
+typedef struct{
+  Frame_Renderer_Path_Type type;
+  Frame_Renderer_Vec2f p[3];
+}Frame_Renderer_Path_Cmd;
+
+typedef struct{
+  unsigned long long hash;
+  unsigned long long last_used;
+  Frame_Renderer_Fill_Rule rule;
+
+  // commands relative to the first point, to verify a hit
+  Frame_Renderer_Path_Cmd *cmds;
+  int cmds_count;
+
+  // triangles relative to the first point
+  Frame_Renderer_Vec2f *verticies;
+  int verticies_count;
+  Frame_Renderer_Vec2f min, max;
+  bool convex;
+}Frame_Renderer_Path_Entry;
+
+#define FRAME_RENDERER_PATH_CAP 1024
+#define FRAME_RENDERER_PATH_CACHE_CAP 64
+#define FRAME_RENDERER_PATH_TOLERANCE 0.25f
+
+// Textures
+//   Handles index a registry, the GL texture is bound on demand. Textures that were
+//   not used in the current frame are evicted, least recently used first, when the
+//   budget would be exceeded, and restored from system memory on their next use.
+#define FRAME_RENDERER_TEXTURE_UNIT 0 // sampler 'tex'
+#define FRAME_RENDERER_FONT_UNIT 1    // sampler 'font_tex'
+#define FRAME_RENDERER_UPLOAD_UNIT 2  // uploads, so they do not disturb the samplers
+#define FRAME_RENDERER_TEXTURE_BUDGET ((size_t) 512 * 1024 * 1024)
+
+// Flags of frame_renderer_push_texture_ex
+#define FRAME_RENDERER_TEXTURE_ATLAS 0x1 // share a page with other small images
+#define FRAME_RENDERER_TEXTURE_MIPMAPS 0x2 // box filtered on the cpu, sampled trilinear
+
+// Yuv textures
+//   The luma plane is bound as 'tex', the chroma planes on their own units. The
+//   fragment shader converts to rgb, default is BT.601 with limited range.
+#define FRAME_RENDERER_YUV_U_UNIT 3 // sampler 'tex_u', interleaved uv for nv12
+#define FRAME_RENDERER_YUV_V_UNIT 4 // sampler 'tex_v'
+
+#define FRAME_RENDERER_YUV_BT709 0x1
+#define FRAME_RENDERER_YUV_FULL_RANGE 0x2
+
+typedef enum{
+  FRAME_RENDERER_YUV_NONE = 0, // rgba
+  FRAME_RENDERER_YUV_NV12,     // y plane, then interleaved uv at half resolution
+  FRAME_RENDERER_YUV_I420,     // y, u and v plane, u and v at half resolution
+}Frame_Renderer_Yuv_Format;
+
+// Atlas
+//   Small rgba images are packed into shared pages with a skyline packer, so drawing
+//   them does not break the batch. Every image is surrounded by its extruded edge
+//   pixels against bleeding. When all pages are full, the pages are repacked.
+#define FRAME_RENDERER_ATLAS_SIZE 2048
+#define FRAME_RENDERER_ATLAS_MAX_SIZE 256 // larger images get their own texture
+#define FRAME_RENDERER_ATLAS_PADDING 2
+#define FRAME_RENDERER_ATLAS_PAGES_CAP 8
+#define FRAME_RENDERER_ATLAS_NODES_CAP 512
+
+typedef struct{
+  int x, y, width;
+}Frame_Renderer_Atlas_Node;
+
+// Workers
+//   run is called on a worker thread, then finish on the gl thread in frame_renderer_begin.
+//   finish owns the work, it is also called for cancelled work that never ran. Work
+//   cancelled while queued is not run.
+#define FRAME_RENDERER_WORKERS_CAP 8
+#define FRAME_RENDERER_UPLOAD_BUDGET_MS 2.0f // time per frame for finishing work
+#define FRAME_RENDERER_PLACEHOLDER_COLOR frame_renderer_vec4f(.5f, .5f, .5f, .5f) // images that are loading
+
+typedef struct Frame_Renderer_Work Frame_Renderer_Work;
+
+struct Frame_Renderer_Work{
+  void (*run)(Frame_Renderer_Work *work);
+  void (*finish)(Frame_Renderer_Work *work);
+  volatile bool cancelled; // set on the gl thread, read by the workers
+  Frame_Renderer_Work *next;
+};
+
+typedef struct{
+  HANDLE threads[FRAME_RENDERER_WORKERS_CAP];
+  int threads_count;
+  CRITICAL_SECTION lock;
+  CONDITION_VARIABLE wake;
+  Frame_Renderer_Work *queue_first, *queue_last;
+  Frame_Renderer_Work *finished_first, *finished_last;
+  bool stop;
+}Frame_Renderer_Pool;
+
+typedef struct{
+  unsigned int texture;
+  Frame_Renderer_Atlas_Node nodes[FRAME_RENDERER_ATLAS_NODES_CAP]; // skyline, sorted by x
+  int nodes_count;
+  size_t released_area;
+}Frame_Renderer_Atlas_Page;
+
+// Streaming textures
+//   A ring of pixel buffers. The caller writes the next frame into a mapped buffer
+//   while the gpu still copies the previous ones into the texture.
+#define FRAME_RENDERER_STREAM_BUFFERS 3
+
+typedef struct{
+  GLuint buffers[FRAME_RENDERER_STREAM_BUFFERS];
+  GLsync fences[FRAME_RENDERER_STREAM_BUFFERS]; // NULL once the copy out of the buffer is done
+  int index; // buffer that is mapped next
+  bool mapped;
+  size_t commits;
+  size_t dropped; // maps while every buffer was in flight
+}Frame_Renderer_Stream;
+
+typedef struct{
+  GLuint name;  // 0 while evicted
+  int width, height;
+  bool grey;
+  bool used;
+  bool pinned;  // fonts and render targets are never evicted
+  int levels;   // mip levels on the gpu, 1 without mipmaps
+  size_t bytes; // of all levels
+  unsigned char *pixels; // content while evicted, or of an atlas image
+  unsigned long long last_used;
+
+  // atlas images live at x, y on a page and have no name of their own
+  bool atlas;
+  int page; // -1 while not placed
+  int x, y;
+
+  // frame_renderer_push_image_async
+  bool loading;
+  bool failed;
+  Frame_Renderer_Work *work;
+
+  Frame_Renderer_Stream *stream; // frame_renderer_create_stream
+
+  // frame_renderer_create_yuv_texture, name holds the y plane
+  Frame_Renderer_Yuv_Format yuv;
+  int yuv_flags;
+  GLuint planes[2];
+}Frame_Renderer_Texture;
+
+typedef enum{
+  FRAME_RENDERER_TEXTURE_INVALID = 0,
+  FRAME_RENDERER_TEXTURE_LOADING,
+  FRAME_RENDERER_TEXTURE_READY,
+  FRAME_RENDERER_TEXTURE_FAILED,
+}Frame_Renderer_Texture_State;
+
+typedef struct{
+  size_t budget;
+  size_t resident_bytes; // on the gpu
+  size_t evicted_bytes;  // in system memory
+  int resident;
+  int evicted;
+  int evictions;
+  int restores;
+}Frame_Renderer_Texture_Memory;
+
+// Asset packs
+//   A header, the entries and aligned blobs, written by tools/pack.c. The pack is
+//   mapped and the blobs are handed to stb and gl where they are.
+#define FRAME_RENDERER_PACK_MAGIC 0x4b505246 // 'FRPK'
+#define FRAME_RENDERER_PACK_VERSION 1
+#define FRAME_RENDERER_PACK_ALIGNMENT 64
+#define FRAME_RENDERER_PACK_NAME_CAP 64
+#define FRAME_RENDERER_PACK_FONT_CHARS_SIZE 1920 // stbtt_bakedchar[96]
+
+typedef enum{
+  FRAME_RENDERER_PACK_FILE = 0, // as it was on disk, fonts are kept as ttf
+  FRAME_RENDERER_PACK_TEXTURE,  // rgba
+  FRAME_RENDERER_PACK_FONT,     // baked, the chars of ASCII 32..127 and then the grey atlas
+}Frame_Renderer_Pack_Kind;
+
+typedef struct{
+  unsigned int magic;
+  unsigned int version;
+  unsigned int entries_count;
+  unsigned int reserved;
+}Frame_Renderer_Pack_Header;
+
+typedef struct{
+  char name[FRAME_RENDERER_PACK_NAME_CAP]; // relative to the packed directory
+  unsigned int kind;
+  int width, height;  // of textures and font atlases
+  float pixel_height; // of fonts
+  unsigned long long offset;
+  unsigned long long size;
+}Frame_Renderer_Pack_Entry;
+
+typedef struct{
+  HANDLE file, mapping;
+  const unsigned char *view;
+  size_t size;
+}Frame_Renderer_File_Map;
+
+// What a cache entry remembers of its source file
+typedef struct{
+  unsigned long long size;
+  unsigned long long time; // last write
+  unsigned long long hash; // of the content
+}Frame_Renderer_File_Stamp;
+
+typedef struct{
+  HANDLE file;
+  HANDLE mapping;
+  const unsigned char *view;
+  size_t size;
+  const Frame_Renderer_Pack_Entry *entries;
+  unsigned int entries_count;
+}Frame_Renderer_Pack;
+
+typedef struct{
+  GLuint fbo, rbo;
+  GLuint texture;
+  unsigned int index;
+  int width, height;           // allocated
+  int used_width, used_height; // requested
+  bool created;
+  bool in_use;
+}Frame_Renderer_Target;
+
+#define FRAME_RENDERER_TARGETS_CAP 8
+
+typedef enum{
+  FRAME_RENDERER_FLUSH_CAPACITY = 0, // vertex buffer is full
+  FRAME_RENDERER_FLUSH_TEXTURE,      // texture switch
+  FRAME_RENDERER_FLUSH_END,          // end of frame
+  FRAME_RENDERER_FLUSH_STATE,        // paths, render targets
+  FRAME_RENDERER_FLUSH_COUNT,
+}Frame_Renderer_Flush_Reason;
+
+#ifdef FRAME_STATS
+#define FRAME_RENDERER_STATS_HISTORY 120
+
+typedef struct{
+  unsigned long long frame;
+  int draw_calls;
+  int verticies;
+  size_t bytes_uploaded;
+  int texture_binds;
+  int uniform_updates;
+  int flushes[FRAME_RENDERER_FLUSH_COUNT];
+  int text_runs; // lookups of the text run cache
+  int text_run_hits;
+}Frame_Renderer_Stats;
+#endif //FRAME_STATS
+
+#ifdef FRAME_GPU_TIMER
+// Results are read FRAME_RENDERER_GPU_TIMER_FRAMES frames later, so they never block
+#define FRAME_RENDERER_GPU_TIMER_FRAMES 4
+#define FRAME_RENDERER_GPU_TIMER_BATCHES 64
+
+typedef struct{
+  double clear_ms;
+  double swap_ms;
+  double batches_ms[FRAME_RENDERER_GPU_TIMER_BATCHES];
+  int batches_count;
+  double total_ms;
+  unsigned long long frame;
+}Frame_Renderer_Gpu_Timing;
+
+typedef struct{
+  GLuint clear, swap;
+  GLuint batches[FRAME_RENDERER_GPU_TIMER_BATCHES];
+  int batches_count;
+  bool clear_issued;
+  bool swap_issued;
+  unsigned long long frame;
+}Frame_Renderer_Gpu_Timer_Frame;
+#endif //FRAME_GPU_TIMER
+
+#ifdef FRAME_STB_TRUETYPE
+// Glyph cache
+//   Glyphs are rasterized when they are first needed and packed into shelves of one
+//   grey atlas. When the atlas is full, the least recently drawn shelf is emptied.
+//   Glyphs of baked fonts can not be rasterized again, their shelves are pinned. Glyphs
+//   without pixels are on no shelf, they share one list that is emptied like a shelf.
+#define FRAME_RENDERER_GLYPH_ATLAS_SIZE 1024
+#define FRAME_RENDERER_GLYPHS_CAP 4096 // power of two
+#define FRAME_RENDERER_GLYPH_SHELVES_CAP 256
+#define FRAME_RENDERER_GLYPH_SHELF_ROUNDING 4 // shelf heights are multiples of it
+#define FRAME_RENDERER_GLYPH_PADDING 1
+#define FRAME_RENDERER_FONTS_CAP 16
+#define FRAME_RENDERER_FONT_TABLE_SIZE 256 // codepoints with precomputed advances and kerning
+
+typedef struct{
+  int font;
+  int codepoint;
+  float size;
+  short x0, y0, x1, y1; // in the atlas, as stbtt_bakedchar
+  float xoff, yoff, xadvance;
+  int shelf; // -1 without pixels
+  int next;  // in the bucket, or in the free list
+  int shelf_next; // in the shelf, or in the list of glyphs without pixels
+}Frame_Renderer_Glyph;
+
+typedef struct{
+  int y, height;
+  int x; // first free column
+  int glyphs;
+  unsigned long long last_used;
+  int pinned; // id of the baked font it holds glyphs of, 0 for none
+  unsigned int generation; // new whenever it is emptied
+}Frame_Renderer_Glyph_Shelf;
+
+// Signed distance field fonts
+//   Glyphs are rasterized once at FRAME_RENDERER_SDF_SIZE and stay sharp at any scale.
+//   The distance is 0.5 on the edge and falls by 0.5/FRAME_RENDERER_SDF_PADDING per pixel,
+//   reaching 0 at FRAME_RENDERER_SDF_PADDING pixels outside.
+#define FRAME_RENDERER_FONT_SDF 0x1
+#define FRAME_RENDERER_SDF_SIZE 48.0f
+#define FRAME_RENDERER_SDF_PADDING 6
+
+typedef struct{
+  int codepoint;
+  int x0, y0; // offset to the pen
+  int width, height;
+  float xadvance;
+  unsigned char *pixels; // padded by FRAME_RENDERER_GLYPH_PADDING, NULL for none
+}Frame_Renderer_Glyph_Bitmap;
+
+typedef struct{
+  unsigned int pair; // left << 8 | right, 0 for an empty slot
+  float kern;
+}Frame_Renderer_Kern_Pair;
+
+typedef struct{
+  bool used;
+  int id; // of its glyphs in the cache
+  stbtt_fontinfo info;
+  bool rasterize; // false for baked fonts
+  bool sdf;
+  unsigned char *data; // owned, or
+  Frame_Renderer_File_Map map; // the file it was pushed from, mapped as long as the font lives
+  float height; // pixel height
+  float size;   // pixel height the glyphs are rasterized at
+  float scale;
+  float quad_scale; // height / size
+  float ascent, descent; // around the baseline, descent is negative
+
+  // in pixels as the glyphs are drawn, for FRAME_RENDERER_FONT_TABLE_SIZE codepoints
+  float advances[FRAME_RENDERER_FONT_TABLE_SIZE];
+  Frame_Renderer_Kern_Pair *kerning; // open addressing, only pairs that kern
+  int kerning_cap; // power of two, 0 without kerning
+  int kerning_count;
+  unsigned int kerning_rows[FRAME_RENDERER_FONT_TABLE_SIZE / 32]; // left codepoints whose pairs are in the table
+}Frame_Renderer_Font;
+
+typedef struct{
+  float outline; // in pixels at FRAME_RENDERER_SDF_SIZE, up to FRAME_RENDERER_SDF_PADDING
+  Frame_Renderer_Vec4f outline_color;
+  float glow;
+  Frame_Renderer_Vec4f glow_color;
+}Frame_Renderer_Text_Effect;
+
+// Text runs
+//   Laid out strings, keyed by the font, the hash of the string and the scale. The quads
+//   are relative to the position of the text, drawing a run again only moves them. A run
+//   is laid out again when one of the shelves it samples was emptied.
+#define FRAME_RENDERER_TEXT_RUNS_CAP 128
+#define FRAME_RENDERER_TEXT_RUN_LEN_CAP 512 // longer strings are laid out on every call
+
+typedef struct{
+  int index;
+  unsigned int generation;
+}Frame_Renderer_Text_Run_Shelf;
+
+typedef struct{
+  unsigned long long hash;
+  unsigned long long last_used;
+  int font; // id, 0 for none
+  float scale;
+  char cstr[FRAME_RENDERER_TEXT_RUN_LEN_CAP]; // to verify a hit
+  size_t cstr_len;
+
+  Frame_Renderer_Vertex *verticies; // the color is set when it is drawn
+  int verticies_count, verticies_cap;
+  Frame_Renderer_Text_Run_Shelf *shelves;
+  int shelves_count, shelves_cap;
+  Frame_Renderer_Vec2f size;
+}Frame_Renderer_Text_Run;
+
+// Wrapped text
+//   Laid out in one pass: lines break at the last space that fits, inside a word only
+//   when the word is wider than the line, and always at '\n'. A '\n' at the end ends the
+//   last line and does not start an empty one. Measuring, hit testing and drawing share
+//   the line table, the layout keeps its memory between calls.
+typedef struct{
+  size_t start, len; // bytes, without the spaces it broke at
+  float width;
+}Frame_Renderer_Text_Line;
+
+typedef struct{
+  unsigned int font;
+  float scale;
+  float line_height;
+  Frame_Renderer_Vec2f size; // widest line x all lines
+  Frame_Renderer_Text_Line *lines;
+  int lines_count, lines_cap;
+}Frame_Renderer_Text_Layout;
+
+// Text views
+//   Text that only grows, wrapped as the layouts are. The view keeps a copy and its lines,
+//   which are drawn as the layouts draw them. Appending lays out again from the start of
+//   the last line, breaks before it do not depend on what follows. Drawing looks up the lines in the view by the scroll
+//   offset and emits only those.
+typedef struct{
+  unsigned int font;
+  float width, scale;
+  float line_height;
+  char *text;
+  size_t text_len, text_cap;
+  Frame_Renderer_Text_Line *lines; // into the whole text
+  size_t lines_count, lines_cap;
+}Frame_Renderer_Text_View;
+
+#define FRAME_RENDERER_TEXT_VIEW_CHUNK (1 << 20) // bytes laid out at once when the width changes
+#endif //FRAME_STB_TRUETYPE
+
 typedef struct{
   GLuint vao, vbo;
   GLuint vertex_shader, fragment_shader;
   GLuint program;
   
-  GLuint textures;
-  unsigned int images_count;
+  Frame_Renderer_Texture *textures;
+  unsigned int textures_count, textures_cap;
+  unsigned long long texture_tick;
+  Frame_Renderer_Texture_Memory texture_memory;
+  int texture_flags;
+  int max_resident_mip;
+
+  Frame_Renderer_Atlas_Page atlas_pages[FRAME_RENDERER_ATLAS_PAGES_CAP];
+  int atlas_pages_count;
+
+  Frame_Renderer_Pool pool;
+  bool pool_started;
+  float upload_budget_ms;
 
 #ifdef FRAME_STB_TRUETYPE
-  float font_height;
-  stbtt_bakedchar font_cdata[96]; // ASCII 32..126 is 95 glyphs
+  Frame_Renderer_Font fonts[FRAME_RENDERER_FONTS_CAP];
+  int font_current; // of the calls without a font, -1 without fonts
+  int font_id; // last one given out, glyphs of released fonts are not found anymore
+  Frame_Renderer_Glyph glyphs[FRAME_RENDERER_GLYPHS_CAP];
+  int glyph_buckets[FRAME_RENDERER_GLYPHS_CAP];
+  int glyphs_free;
+  int glyphs_empty; // without pixels
+  unsigned long long glyphs_empty_used;
+  Frame_Renderer_Glyph_Shelf glyph_shelves[FRAME_RENDERER_GLYPH_SHELVES_CAP];
+  int glyph_shelves_count;
+  int glyph_bottom; // first row below the shelves
+  unsigned int glyph_generation; // last one given to a shelf
+  Frame_Renderer_Text_Run text_runs[FRAME_RENDERER_TEXT_RUNS_CAP];
+  Frame_Renderer_Text_Run text_scratch; // strings that are not cached
+  unsigned long long text_run_tick;
+  Frame_Renderer_Text_Layout text_layout; // of text_wrapped
+  int font_flags;
+  Frame_Renderer_Text_Effect text_effect;
 #endif //FRAME_STB_TRUETYPE
+
+#ifdef FRAME_STB_IMAGE
+  char image_cache_dir[MAX_PATH]; // empty without cache
+  size_t image_cache_cap;
+  bool image_cache_stored; // entries were written since the last trim
+  int image_jobs; // loading
+#endif //FRAME_STB_IMAGE
     
   int font_index;
   int tex_index;
+  Frame_Renderer_Yuv_Format tex_yuv; // what the shader converts from
+  int tex_yuv_flags;
 
   float width, height;
   Frame_Renderer_Vec4f background;
@@ -159,6 +694,37 @@ typedef struct{
   Frame_Renderer_Vertex verticies[FRAME_RENDERER_CAP];
   int verticies_count;
 
+  //Path things
+  Frame_Renderer_Path_Cmd path_cmds[FRAME_RENDERER_PATH_CAP];
+  int path_cmds_count;
+  Frame_Renderer_Path_Entry path_cache[FRAME_RENDERER_PATH_CACHE_CAP];
+  unsigned long long path_tick;
+  Frame_Renderer_Vec2f *path_points;
+  int path_points_count, path_points_cap;
+  int *path_contours;
+  int path_contours_count, path_contours_cap;
+  GLint stencil_bits;
+
+  //Render targets
+  Frame_Renderer_Target targets[FRAME_RENDERER_TARGETS_CAP];
+  int target_active; // -1 for the window
+
+#ifdef FRAME_STATS
+  Frame_Renderer_Stats stats;
+  Frame_Renderer_Stats stats_history[FRAME_RENDERER_STATS_HISTORY];
+  int stats_history_count;
+  int stats_history_index;
+#endif //FRAME_STATS
+
+#ifdef FRAME_GPU_TIMER
+  Frame_Renderer_Gpu_Timer_Frame gpu_timer_frames[FRAME_RENDERER_GPU_TIMER_FRAMES];
+  int gpu_timer_index;
+  bool gpu_timer_active;
+  unsigned long long gpu_timer_frame;
+  Frame_Renderer_Gpu_Timing gpu_timing;
+  bool gpu_timing_valid;
+#endif //FRAME_GPU_TIMER
+
   //Imgui things
   Frame_Renderer_Vec2f input;
   Frame_Renderer_Vec2f pos;
@@ -184,10 +750,30 @@ static Frame_Renderer_Vec4f BLACK = {0, 0, 0, 1};
 #define draw_solid_rounded_shaded_rect frame_renderer_solid_rounded_shaded_rect
 #define draw_solid_rect_angle frame_renderer_solid_rect_angle
 #define push_texture frame_renderer_push_texture
+#define push_texture_ex frame_renderer_push_texture_ex
+#define release_texture frame_renderer_release_texture
+#define create_stream frame_renderer_create_stream
+#define stream_map frame_renderer_stream_map
+#define stream_commit frame_renderer_stream_commit
+#define push_yuv frame_renderer_push_yuv
+#define push_image_from_pack frame_renderer_push_image_from_pack
 #define draw_texture frame_renderer_texture
 #define draw_texture_colored frame_renderer_texture_colored
 #define draw_solid_circle frame_renderer_solid_circle
 
+#define path_begin frame_renderer_path_begin
+#define path_move_to frame_renderer_path_move_to
+#define path_line_to frame_renderer_path_line_to
+#define path_quad_to frame_renderer_path_quad_to
+#define path_cubic_to frame_renderer_path_cubic_to
+#define path_close frame_renderer_path_close
+#define draw_path frame_renderer_path_fill
+
+#define target_create frame_renderer_target_create
+#define target_begin frame_renderer_target_begin
+#define target_end frame_renderer_target_end
+#define draw_target frame_renderer_target_draw
+
 #define button frame_renderer_button
 #define texture_button frame_renderer_texture_button
 #define texture_button_ex frame_renderer_texture_button_ex
@@ -195,6 +781,14 @@ static Frame_Renderer_Vec4f BLACK = {0, 0, 0, 1};
 #ifdef FRAME_STB_TRUETYPE
 #  define push_font frame_renderer_push_font
 #  define push_font_memory frame_renderer_push_font_memory
+#  define push_font_from_pack frame_renderer_push_font_from_pack
+#  define push_font_baked frame_renderer_push_font_baked
+#  define bake_font frame_renderer_font_bake
+#  define save_font_cache frame_renderer_save_font_cache
+#  define load_font_cache frame_renderer_load_font_cache
+#  define release_font frame_renderer_release_font
+#  define draw_font_text(font, cstr, pos, factor, color) frame_renderer_font_text((font), (cstr), strlen((cstr)), (pos), (factor), (color))
+#  define measure_font_text(font, cstr, factor, size) frame_renderer_font_measure_text((font), (cstr), strlen((cstr)), (factor), (size))
 #  define draw_text(cstr, pos, factor) frame_renderer_text((cstr), strlen((cstr)), (pos), (factor), (WHITE))
 #  define draw_text_colored(cstr, pos, factor, color) frame_renderer_text((cstr), strlen((cstr)), (pos), (factor), (color))
 #  define draw_text_len(cstr, cstr_len, pos, factor) frame_renderer_text((cstr), (cstr_len), (pos), (factor), (WHITE))
@@ -204,11 +798,15 @@ static Frame_Renderer_Vec4f BLACK = {0, 0, 0, 1};
 #  define measure_text_len(cstr, cstr_len, factor, size) frame_renderer_measure_text((cstr), (cstr_len), (factor), (size));
 
 #  define draw_text_wrapped frame_renderer_text_wrapped
+#  define layout_text(cstr, width, factor, layout) frame_renderer_layout_text((cstr), strlen((cstr)), (width), (factor), (layout))
+#  define draw_text_layout frame_renderer_text_layout_draw
+#  define draw_text_view frame_renderer_text_view_draw
 #endif //FRAME_STB_TRUETYPE
 
 #ifdef FRAME_STB_IMAGE
 #  define push_image frame_renderer_push_image
 #  define push_image_memory frame_renderer_push_image_memory
+#  define push_image_async frame_renderer_push_image_async
 #endif //FRAME_STB_IMAGE
 
 FRAME_DEF bool frame_renderer_init(Frame_Renderer *r);
@@ -234,11 +832,78 @@ FRAME_DEF void frame_renderer_solid_rounded_shaded_rect(Frame_Renderer_Vec2f pos
 FRAME_DEF void frame_renderer_solid_rect_angle(Frame_Renderer_Vec2f pos, Frame_Renderer_Vec2f size, float angle, Frame_Renderer_Vec4f color);
 FRAME_DEF bool frame_renderer_create_texture(int width, int height, unsigned int *index);
 FRAME_DEF bool frame_renderer_push_to_texture(unsigned int tex, const void *data, int x_off, int y_off, int width, int height);
+// Rgba textures for video-rate content: map, write width * height * 4 bytes, commit.
+// map fails without waiting, when the gpu is still busy with every buffer, and the frame should be dropped.
+FRAME_DEF bool frame_renderer_create_stream(int width, int height, unsigned int *index);
+FRAME_DEF bool frame_renderer_stream_map(unsigned int tex, void **pixels);
+FRAME_DEF bool frame_renderer_stream_commit(unsigned int tex);
+FRAME_DEF bool frame_renderer_stream_counts(unsigned int tex, size_t *commits, size_t *dropped);
+// Planar yuv, 1.5 bytes per pixel. Strides are in bytes, for nv12 'u' is the uv plane and 'v' is unused.
+// Drawn with frame_renderer_texture and frame_renderer_texture_colored.
+FRAME_DEF bool frame_renderer_create_yuv_texture(int width, int height, Frame_Renderer_Yuv_Format format, int flags, unsigned int *index);
+FRAME_DEF bool frame_renderer_push_yuv(unsigned int tex, const void *y, int y_stride, const void *u, int u_stride, const void *v, int v_stride);
 FRAME_DEF bool frame_renderer_push_texture(int width, int height, const void *data, bool grey, unsigned int *index);
+FRAME_DEF bool frame_renderer_push_texture_ex(int width, int height, const void *data, bool grey, int flags, unsigned int *index);
 FRAME_DEF void frame_renderer_texture(unsigned int texture, Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s, Frame_Renderer_Vec2f uvp, Frame_Renderer_Vec2f uvs);
 FRAME_DEF void frame_renderer_texture_colored(unsigned int texture, Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s, Frame_Renderer_Vec2f uvp, Frame_Renderer_Vec2f uvs, Frame_Renderer_Vec4f c);
 FRAME_DEF void frame_renderer_solid_circle(Frame_Renderer_Vec2f pos, float start_angle, float end_angle, float radius, int parts, Frame_Renderer_Vec4f color);
 
+FRAME_DEF void frame_renderer_release_texture(unsigned int texture);
+FRAME_DEF void frame_renderer_set_texture_flags(int flags); // used by push_texture and push_image
+// Mipmapped textures drop their 'level' largest levels, 0 keeps the full image.
+// They are updated as a whole with push_to_texture, at the size frame_renderer_texture_size reports.
+FRAME_DEF void frame_renderer_set_max_resident_mip(int level);
+FRAME_DEF bool frame_renderer_repack_atlas();
+FRAME_DEF void frame_renderer_set_texture_budget(size_t bytes);
+FRAME_DEF void frame_renderer_set_upload_budget(float ms);
+FRAME_DEF Frame_Renderer_Texture_State frame_renderer_texture_state(unsigned int texture);
+FRAME_DEF bool frame_renderer_texture_size(unsigned int texture, int *width, int *height);
+FRAME_DEF void frame_renderer_texture_memory(Frame_Renderer_Texture_Memory *memory);
+FRAME_DEF bool frame_renderer_texture_bytes(unsigned int texture, size_t *bytes, bool *resident);
+
+// The pack can be closed once everything is pushed.
+FRAME_DEF bool frame_renderer_pack_open(const char *filepath, Frame_Renderer_Pack *pack);
+FRAME_DEF void frame_renderer_pack_close(Frame_Renderer_Pack *pack);
+FRAME_DEF const Frame_Renderer_Pack_Entry *frame_renderer_pack_find(const Frame_Renderer_Pack *pack, const char *name, Frame_Renderer_Pack_Kind kind, float pixel_height);
+FRAME_DEF const void *frame_renderer_pack_data(const Frame_Renderer_Pack *pack, const Frame_Renderer_Pack_Entry *entry);
+// A pre-decoded texture, or with FRAME_STB_IMAGE an image file decoded from the mapping
+FRAME_DEF bool frame_renderer_push_image_from_pack(const Frame_Renderer_Pack *pack, const char *name, int *width, int *height, unsigned int *index);
+
+// Paths
+//   Filled outlines. Tessellations are cached by the hash of the path relative
+//   to its first point, so a static shape (also when moved) is only tessellated once.
+FRAME_DEF void frame_renderer_path_begin();
+FRAME_DEF void frame_renderer_path_move_to(Frame_Renderer_Vec2f p);
+FRAME_DEF void frame_renderer_path_line_to(Frame_Renderer_Vec2f p);
+FRAME_DEF void frame_renderer_path_quad_to(Frame_Renderer_Vec2f c, Frame_Renderer_Vec2f p);
+FRAME_DEF void frame_renderer_path_cubic_to(Frame_Renderer_Vec2f c1, Frame_Renderer_Vec2f c2, Frame_Renderer_Vec2f p);
+FRAME_DEF void frame_renderer_path_close();
+FRAME_DEF void frame_renderer_path_fill(Frame_Renderer_Fill_Rule rule, Frame_Renderer_Vec4f color);
+
+// Render targets
+//   Everything between begin and end is rendered into an offscreen texture.
+//   Released targets stay in a pool and are handed out again by create.
+//   The content is premultiplied and upside down, draw it with frame_renderer_target_draw.
+FRAME_DEF bool frame_renderer_target_create(int width, int height, unsigned int *target);
+FRAME_DEF bool frame_renderer_target_resize(unsigned int target, int width, int height);
+FRAME_DEF void frame_renderer_target_release(unsigned int target);
+FRAME_DEF bool frame_renderer_target_begin(unsigned int target);
+FRAME_DEF void frame_renderer_target_end();
+FRAME_DEF unsigned int frame_renderer_target_texture(unsigned int target);
+FRAME_DEF void frame_renderer_target_draw(unsigned int target, Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s, Frame_Renderer_Vec4f c);
+
+#ifdef FRAME_STATS
+// Counters of the last complete frame, and the sum over the last FRAME_RENDERER_STATS_HISTORY frames
+FRAME_DEF bool frame_renderer_stats(Frame_Renderer_Stats *stats);
+FRAME_DEF bool frame_renderer_stats_sum(Frame_Renderer_Stats *sum, int *frames);
+#endif //FRAME_STATS
+
+#ifdef FRAME_GPU_TIMER
+// GPU timings of the clear, every batch and the swap, some frames behind
+FRAME_DEF bool frame_renderer_gpu_timing(Frame_Renderer_Gpu_Timing *timing);
+FRAME_DEF void frame_renderer_gpu_overlay(Frame_Renderer_Vec2f pos, float scale);
+#endif //FRAME_GPU_TIMER
+
 //Imgui-things
 FRAME_DEF bool frame_renderer_button(Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s, Frame_Renderer_Vec4f c);
 FRAME_DEF bool frame_renderer_texture_button(unsigned int texture, Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s);
@@ -247,11 +912,50 @@ FRAME_DEF bool frame_renderer_texture_button_ex(unsigned int texture, Frame_Rend
 FRAME_DEF bool frame_renderer_slider(Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s, Frame_Renderer_Vec4f knot_color, Frame_Renderer_Vec4f color, float value, float *cursor);
 
 #ifdef FRAME_STB_TRUETYPE
-FRAME_DEF bool frame_renderer_push_font(const char *filepath, float pixel_height);
-FRAME_DEF bool frame_renderer_push_font_memory(unsigned char *memory, size_t memory_len, float pixel_height);
+// Every pushed font becomes the one of the calls without a font. All fonts share the
+// glyph cache, text in different fonts is drawn in one batch.
+FRAME_DEF bool frame_renderer_push_font(const char *filepath, float pixel_height, unsigned int *font);
+FRAME_DEF bool frame_renderer_push_font_memory(unsigned char *memory, size_t memory_len, float pixel_height, unsigned int *font);
+// The font baked at 'pixel_height', or else baked now from the ttf in the pack
+FRAME_DEF bool frame_renderer_push_font_from_pack(const Frame_Renderer_Pack *pack, const char *name, float pixel_height, unsigned int *font);
+// A font baked ahead of time, 'chars' are the stbtt_bakedchar of ASCII 32..127 (see tools/embed.c).
+// Its glyphs are copied into the glyph cache, other codepoints are not drawn.
+FRAME_DEF bool frame_renderer_push_font_baked(const void *chars, const unsigned char *atlas, int width, int height, float pixel_height, unsigned int *font);
+FRAME_DEF void frame_renderer_release_font(unsigned int font);
+FRAME_DEF void frame_renderer_set_font(unsigned int font);
+FRAME_DEF void frame_renderer_font_measure_text(unsigned int font, const char *cstr, size_t cstr_len, float scale, Vec2f *size);
+FRAME_DEF void frame_renderer_font_text(unsigned int font, const char *cstr, size_t cstr_len, Frame_Renderer_Vec2f pos, float scale, Frame_Renderer_Vec4f color);
+FRAME_DEF void frame_renderer_font_text_wrapped(unsigned int font, const char *cstr, size_t cstr_len, Frame_Renderer_Vec2f *pos, Frame_Renderer_Vec2f size, float scale, Frame_Renderer_Vec4f color);
+FRAME_DEF void frame_renderer_set_font_flags(int flags); // used by push_font and push_font_memory
+// Rasterizes the codepoints first..first+count-1 on the workers and puts them into the
+// glyph cache, instead of when they are first drawn. 'ms' is the time it took, or NULL.
+FRAME_DEF bool frame_renderer_font_bake(unsigned int font, int first, int count, double *ms);
+// The cached glyphs of the font from 'filepath', with its metrics and kerning, are kept in
+// 'dir' under the path and pixel height. Loading maps the entry and uploads its atlas without
+// parsing the ttf, it fails when there is none or the file changed. Like baked fonts, codepoints
+// that were not cached are not drawn.
+FRAME_DEF bool frame_renderer_save_font_cache(unsigned int font, const char *filepath, const char *dir);
+FRAME_DEF bool frame_renderer_load_font_cache(const char *filepath, float pixel_height, const char *dir, unsigned int *font);
+// Outline and glow around the text of signed distance field fonts, 0 turns them off
+FRAME_DEF void frame_renderer_text_effect(float outline, Frame_Renderer_Vec4f outline_color, float glow, Frame_Renderer_Vec4f glow_color);
 FRAME_DEF void frame_renderer_measure_text(const char *cstr, size_t cstr_len, float scale, Vec2f *size);
 FRAME_DEF void frame_renderer_text(const char *cstr, size_t cstr_len, Frame_Renderer_Vec2f pos, float scale, Frame_Renderer_Vec4f color);
 FRAME_DEF void frame_renderer_text_wrapped(const char *cstr, size_t cstr_len, Frame_Renderer_Vec2f *pos, Frame_Renderer_Vec2f size, float scale, Frame_Renderer_Vec4f color);
+// Lines of at most 'width' pixels. The first line sits on the position the layout is
+// drawn at, the others below it.
+FRAME_DEF bool frame_renderer_font_layout_text(unsigned int font, const char *cstr, size_t cstr_len, float width, float scale, Frame_Renderer_Text_Layout *layout);
+FRAME_DEF bool frame_renderer_layout_text(const char *cstr, size_t cstr_len, float width, float scale, Frame_Renderer_Text_Layout *layout);
+FRAME_DEF void frame_renderer_text_layout_draw(const Frame_Renderer_Text_Layout *layout, const char *cstr, Frame_Renderer_Vec2f pos, Frame_Renderer_Vec4f color);
+// Byte offset of the caret position closest to 'point'
+FRAME_DEF size_t frame_renderer_text_layout_hit(const Frame_Renderer_Text_Layout *layout, const char *cstr, Frame_Renderer_Vec2f pos, Frame_Renderer_Vec2f point);
+FRAME_DEF void frame_renderer_text_layout_free(Frame_Renderer_Text_Layout *layout);
+FRAME_DEF bool frame_renderer_text_view_init(Frame_Renderer_Text_View *view, unsigned int font, float width, float scale);
+FRAME_DEF bool frame_renderer_text_view_append(Frame_Renderer_Text_View *view, const char *cstr, size_t cstr_len);
+// Lays out all the text again
+FRAME_DEF bool frame_renderer_text_view_set_width(Frame_Renderer_Text_View *view, float width);
+// 'scroll' is in pixels from the top of the text. Lines partly inside 'p', 's' are drawn whole.
+FRAME_DEF void frame_renderer_text_view_draw(const Frame_Renderer_Text_View *view, Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s, double scroll, Frame_Renderer_Vec4f color);
+FRAME_DEF void frame_renderer_text_view_free(Frame_Renderer_Text_View *view);
 
 FRAME_DEF bool frame_renderer_text_button(const char *cstr, size_t cstr_len, float scale, Frame_Renderer_Vec4f text_color, Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s, Frame_Renderer_Vec4f c);
 #endif //FRAME_STB_TRUETYPE
@@ -259,6 +963,12 @@ FRAME_DEF bool frame_renderer_text_button(const char *cstr, size_t cstr_len, flo
 #ifdef FRAME_STB_IMAGE
 FRAME_DEF bool frame_renderer_push_image(const char *filepath, int *width, int *height, unsigned int *index);
 FRAME_DEF bool frame_renderer_push_image_memory(unsigned char *data, size_t data_len, int *width, int *height, unsigned int *index);
+// Returns at once, a worker decodes the image. It is drawn as a placeholder until it is uploaded.
+FRAME_DEF bool frame_renderer_push_image_async(const char *filepath, unsigned int *index);
+// push_image and push_image_async keep the decoded images in 'dir'. Entries are checked against the
+// size and time of their source, then its content. 'cap' bytes, least recently used are removed first, 0 for no cap.
+// New entries are trimmed to the cap in frame_renderer_begin, once no image is loading anymore.
+FRAME_DEF bool frame_renderer_set_image_cache(const char *dir, size_t cap);
 #endif //FRAME_STB_IMAGE
 
 #endif //FRAME_NO_RENDERER
@@ -299,9 +1009,39 @@ FRAME_DEF bool frame_renderer_push_image_memory(unsigned char *data, size_t data
 #define GL_SAMPLE_BUFFERS 0x80A8
 #define GL_SAMPLES 0x80A9
 
+#define GL_INCR_WRAP 0x8507
+#define GL_DECR_WRAP 0x8508
+#define GL_STENCIL_BITS 0x0D57
+
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_RENDERBUFFER 0x8D41
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_DEPTH_STENCIL_ATTACHMENT 0x821A
+#define GL_DEPTH24_STENCIL8 0x88F0
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#define GL_STREAM_DRAW 0x88E0
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_CONDITION_SATISFIED 0x911C
+
+#define GL_R8 0x8229
+#define GL_RG 0x8227
+#define GL_RG8 0x822B
+#define GL_TEXTURE_MAX_LEVEL 0x813D
+
 typedef ptrdiff_t GLsizeiptr;
 typedef ptrdiff_t GLintptr;
 typedef char GLchar;
+typedef unsigned long long GLuint64;
 
 void glActiveTexture(GLenum texture);
 void glGenVertexArrays(GLsizei n, GLuint *arrays);
@@ -334,6 +1074,33 @@ void glGetUniformfv(GLuint program, GLint location, GLfloat *params);
 void glGetUniformiv(GLuint program, GLint location, GLsizei bufSize, GLint *params);
 void glSampleCoverage(GLfloat value, GLboolean invert);
 void glCreateTextures(GLenum target, GLsizei n, GLuint *textures);
+void glStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass);
+void glBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+void glGenFramebuffers(GLsizei n, GLuint *framebuffers);
+void glDeleteFramebuffers(GLsizei n, const GLuint *framebuffers);
+void glBindFramebuffer(GLenum target, GLuint framebuffer);
+void glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+GLenum glCheckFramebufferStatus(GLenum target);
+void glGenRenderbuffers(GLsizei n, GLuint *renderbuffers);
+void glDeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers);
+void glBindRenderbuffer(GLenum target, GLuint renderbuffer);
+void glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
+void glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+void glGenQueries(GLsizei n, GLuint *ids);
+void glDeleteQueries(GLsizei n, const GLuint *ids);
+void glBeginQuery(GLenum target, GLuint id);
+void glEndQuery(GLenum target);
+void glGetQueryObjectiv(GLuint id, GLenum pname, GLint *params);
+void glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64 *params);
+void glDeleteBuffers(GLsizei n, const GLuint *buffers);
+void *glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+GLboolean glUnmapBuffer(GLenum target);
+GLsync glFenceSync(GLenum condition, GLbitfield flags);
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
+void glDeleteSync(GLsync sync);
+void glUniform3fv(GLint location, GLsizei count, const GLfloat *value);
+void glUniform4fv(GLint location, GLsizei count, const GLfloat *value);
+void glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value);
 int wglSwapIntervalEXT(GLint interval);
 
 #ifdef FRAME_IMPLEMENTATION
@@ -341,6 +1108,29 @@ int wglSwapIntervalEXT(GLint interval);
 #ifndef FRAME_NO_RENDERER
 static Frame_Renderer frame_renderer;
 static bool frame_renderer_inited = false;
+
+#ifdef FRAME_STATS
+#  define FRAME_RENDERER_STAT(field, n) (frame_renderer.stats.field += (n))
+#else
+#  define FRAME_RENDERER_STAT(field, n)
+#endif //FRAME_STATS
+
+#ifdef FRAME_GPU_TIMER
+typedef enum{
+  FRAME_RENDERER_GPU_TIMER_CLEAR = 0,
+  FRAME_RENDERER_GPU_TIMER_BATCH,
+  FRAME_RENDERER_GPU_TIMER_SWAP,
+}Frame_Renderer_Gpu_Timer_Kind;
+
+FRAME_DEF void frame_renderer_gpu_timer_begin(Frame_Renderer_Gpu_Timer_Kind kind);
+FRAME_DEF void frame_renderer_gpu_timer_end();
+
+#  define FRAME_RENDERER_GPU_TIMER_BEGIN(kind) frame_renderer_gpu_timer_begin((kind))
+#  define FRAME_RENDERER_GPU_TIMER_END() frame_renderer_gpu_timer_end()
+#else
+#  define FRAME_RENDERER_GPU_TIMER_BEGIN(kind)
+#  define FRAME_RENDERER_GPU_TIMER_END()
+#endif //FRAME_GPU_TIMER
 #endif //FRAME_NO_RENDERER
 
 LRESULT CALLBACK Frame_Implementation_WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) {
@@ -455,6 +1245,7 @@ FRAME_DEF bool frame_init(Frame *w, int width, int height, const char *title, in
   desired_format.dwFlags = PFD_SUPPORT_OPENGL|PFD_DRAW_TO_WINDOW|PFD_DOUBLEBUFFER;
   desired_format.cColorBits = 32;
   desired_format.cAlphaBits = 8;
+  desired_format.cStencilBits = 8;
 
   int suggested_format_index = ChoosePixelFormat(w_dc, &desired_format);
   PIXELFORMATDESCRIPTOR suggested_format;
@@ -472,8 +1263,10 @@ FRAME_DEF bool frame_init(Frame *w, int width, int height, const char *title, in
   memcpy(&lptr, &w, sizeof(w));  
   SetWindowLongPtr(w->hwnd, 0, lptr);  
 
-  ShowWindow(w->hwnd, nCmdShow);
-  UpdateWindow(w->hwnd);
+  if(!(flags & FRAME_HIDDEN)) {
+    ShowWindow(w->hwnd, nCmdShow);
+    UpdateWindow(w->hwnd);
+  }
 
   w->running = FRAME_RUNNING;
   w->width = width;
@@ -531,6 +1324,7 @@ FRAME_DEF bool frame_peek(Frame *w, Frame_Event *e) {
     
   MSG *msg = &e->msg;
 
+  FRAME_TRACE_BEGIN("frame_peek");
   while(true) {
     if(!PeekMessage(msg, w->hwnd, 0, 0, PM_REMOVE)) {
       break;
@@ -620,9 +1414,11 @@ FRAME_DEF bool frame_peek(Frame *w, Frame_Event *e) {
 #endif //FRAME_NO_RENDERER
 
     if(e->type != FRAME_EVENT_NONE) {
+      FRAME_TRACE_END();
       return true;
     }
   }
+  FRAME_TRACE_END();
 
   // width, height
   if(!(w->running & FRAME_FULLSCREEN)) {
@@ -644,6 +1440,9 @@ FRAME_DEF bool frame_peek(Frame *w, Frame_Event *e) {
 #ifndef FRAME_NO_RENDERER
   frame_renderer_imgui_begin(w, e);
   frame_renderer_begin(w->width, w->height);
+
+  // closed in frame_swap_buffers
+  FRAME_TRACE_BEGIN("frame_renderer_build");
 #endif // FRAME_NO_RENDERER
 
   return false;
@@ -661,11 +1460,19 @@ FRAME_DEF bool frame_get_mouse_position(Frame *w, float *x, float *y) {
   
 FRAME_DEF void frame_swap_buffers(Frame *w) {
 #ifndef FRAME_NO_RENDERER
+  FRAME_TRACE_END();
   frame_renderer_end();
   frame_renderer_imgui_end();
+  FRAME_RENDERER_GPU_TIMER_BEGIN(FRAME_RENDERER_GPU_TIMER_SWAP);
 #endif // FRAME_NO_RENDERER
-  
+
+  FRAME_TRACE_BEGIN("SwapBuffers");
   SwapBuffers(w->dc);
+  FRAME_TRACE_END();
+
+#ifndef FRAME_NO_RENDERER
+  FRAME_RENDERER_GPU_TIMER_END();
+#endif // FRAME_NO_RENDERER
 }
 
 FRAME_DEF bool frame_toggle_fullscreen(Frame *w) {
@@ -833,6 +1640,190 @@ FRAME_DEF void frame_clipboard_free(Frame_Clipboard *clipboard) {
   CloseClipboard();  
 }
 
+#ifdef FRAME_TRACE
+#include <stdio.h>
+
+#ifdef _MSC_VER
+#  define FRAME_THREAD_LOCAL __declspec(thread)
+#else
+#  define FRAME_THREAD_LOCAL __thread
+#endif
+
+typedef char frame_trace_cap_check[(FRAME_TRACE_CAP & (FRAME_TRACE_CAP - 1)) == 0 ? 1 : -1];
+
+static Frame_Trace_Buffer * volatile frame_trace_buffers = NULL;
+static volatile LONG frame_trace_generation = 0; // bumped by frame_trace_free
+static FRAME_THREAD_LOCAL Frame_Trace_Buffer *frame_trace_buffer = NULL;
+static FRAME_THREAD_LOCAL LONG frame_trace_buffer_generation = 0;
+static INIT_ONCE frame_trace_once = INIT_ONCE_STATIC_INIT;
+static LARGE_INTEGER frame_trace_frequency = {0};
+static LARGE_INTEGER frame_trace_epoch = {0};
+
+FRAME_DEF BOOL CALLBACK frame_trace_init(PINIT_ONCE once, PVOID parameter, PVOID *context) {
+  (void) once;
+  (void) parameter;
+  (void) context;
+  QueryPerformanceFrequency(&frame_trace_frequency);
+  QueryPerformanceCounter(&frame_trace_epoch);
+  return TRUE;
+}
+
+// The buffer of this thread, NULL if it has none or frame_trace_free released it
+FRAME_DEF Frame_Trace_Buffer *frame_trace_current_buffer() {
+  if(frame_trace_buffer_generation != frame_trace_generation) {
+    return NULL;
+  }
+  return frame_trace_buffer;
+}
+
+FRAME_DEF Frame_Trace_Buffer *frame_trace_thread_buffer() {
+  Frame_Trace_Buffer *b = frame_trace_current_buffer();
+  if(b != NULL) {
+    return b;
+  }
+
+  InitOnceExecuteOnce(&frame_trace_once, frame_trace_init, NULL, NULL);
+
+  b = (Frame_Trace_Buffer *) malloc(sizeof(Frame_Trace_Buffer));
+  if(b == NULL) {
+    return NULL;
+  }
+  b->head = 0;
+  b->full = 0;
+  b->depth = 0;
+  b->thread_id = GetCurrentThreadId();
+
+  // push onto the list of all buffers, lock free
+  Frame_Trace_Buffer *head;
+  do {
+    head = frame_trace_buffers;
+    b->next = head;
+  } while(InterlockedCompareExchangePointer((void * volatile *) &frame_trace_buffers, b, head) != head);
+
+  frame_trace_buffer = b;
+  frame_trace_buffer_generation = frame_trace_generation;
+  return b;
+}
+
+FRAME_DEF void frame_trace_begin(const char *name) {
+  Frame_Trace_Buffer *b = frame_trace_thread_buffer();
+  if(b == NULL) {
+    return;
+  }
+
+  if(b->depth < FRAME_TRACE_DEPTH) {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    b->stack_names[b->depth] = name;
+    b->stack_begins[b->depth] = now.QuadPart;
+  }
+  b->depth++;
+}
+
+FRAME_DEF void frame_trace_end() {
+  Frame_Trace_Buffer *b = frame_trace_current_buffer();
+  if(b == NULL || b->depth == 0) {
+    return;
+  }
+
+  b->depth--;
+  if(b->depth >= FRAME_TRACE_DEPTH) {
+    return;
+  }
+
+  LARGE_INTEGER now;
+  QueryPerformanceCounter(&now);
+  
+  DWORD head = b->head;
+  Frame_Trace_Event *event = &b->events[head & (FRAME_TRACE_CAP - 1)];
+  event->name = b->stack_names[b->depth];
+  event->begin = b->stack_begins[b->depth];
+  event->end = now.QuadPart;
+
+  // publish the event only after it is written
+  MemoryBarrier();
+  b->head = head + 1;
+  if(((head + 1) & (FRAME_TRACE_CAP - 1)) == 0) {
+    b->full = 1;
+  }
+}
+
+FRAME_DEF double frame_trace_us(LONGLONG ticks) {
+  return (double) (ticks - frame_trace_epoch.QuadPart) * 1000000.0 / (double) frame_trace_frequency.QuadPart;
+}
+
+FRAME_DEF void frame_trace_write_string(FILE *f, const char *cstr) {
+  fputc('"', f);
+  for(const char *c = cstr;*c;c++) {
+    if(*c == '"' || *c == '\\') {
+      fputc('\\', f);
+      fputc(*c, f);
+    } else if((unsigned char) *c >= 32) {
+      fputc(*c, f);
+    }
+  }
+  fputc('"', f);
+}
+
+FRAME_DEF bool frame_trace_dump(const char *filepath) {
+  FILE *f = fopen(filepath, "wb");
+  if(f == NULL) {
+    FRAME_LOG("Can not open file: %s\n", filepath);
+    return false;
+  }
+
+  DWORD pid = GetCurrentProcessId();
+  bool first = true;
+  
+  fprintf(f, "{\"traceEvents\":[\n");
+  for(Frame_Trace_Buffer *b = frame_trace_buffers;b != NULL;b = b->next) {
+    fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%lu,\"tid\":%lu,\"args\":{\"name\":\"thread %lu\"}}",
+	    first ? "" : ",\n", (unsigned long) pid, (unsigned long) b->thread_id, (unsigned long) b->thread_id);
+    first = false;
+
+    // unsigned differences stay right when head wraps around
+    DWORD head = b->head;
+    DWORD count = b->full ? FRAME_TRACE_CAP : head;
+    for(DWORD k=0;k<count;k++) {
+      DWORD i = head - count + k;
+      Frame_Trace_Event event = b->events[i & (FRAME_TRACE_CAP - 1)];
+
+      // the owner keeps writing, skip what it may have overwritten meanwhile
+      DWORD now = b->head;
+      if(now - i > FRAME_TRACE_CAP - 1) {
+	continue;
+      }
+
+      double ts = frame_trace_us(event.begin);
+      double dur = frame_trace_us(event.end) - ts;
+      fprintf(f, ",\n{\"name\":");
+      frame_trace_write_string(f, event.name);
+      fprintf(f, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lu,\"tid\":%lu}",
+	      ts, dur, (unsigned long) pid, (unsigned long) b->thread_id);
+    }
+  }
+  fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+  bool result = ferror(f) == 0;
+  fclose(f);
+  return result;
+}
+
+FRAME_DEF void frame_trace_free() {
+  // buffers still cached in thread locals go stale with the generation
+  InterlockedIncrement(&frame_trace_generation);
+
+  Frame_Trace_Buffer *b = (Frame_Trace_Buffer *) InterlockedExchangePointer((void * volatile *) &frame_trace_buffers, NULL);
+  while(b != NULL) {
+    Frame_Trace_Buffer *next = b->next;
+    free(b);
+    b = next;
+  }
+  frame_trace_buffer = NULL;
+}
+
+#endif //FRAME_TRACE
+
 FRAME_DEF const char *frame_shader_type_name(GLenum shader) {
   switch (shader) {
   case GL_VERTEX_SHADER:
@@ -920,6 +1911,15 @@ static const char *frame_renderer_fragment_shader_source=
   "\n"
   "uniform sampler2D font_tex;\n"
   "uniform sampler2D tex;\n"
+  "uniform sampler2D tex_u;\n"
+  "uniform sampler2D tex_v;\n"
+  "uniform int tex_yuv;\n"
+  "uniform mat3 yuv_matrix;\n"
+  "uniform vec3 yuv_offset;\n"
+  "uniform float sdf_outline;\n"
+  "uniform vec4 sdf_outline_color;\n"
+  "uniform float sdf_glow;\n"
+  "uniform vec4 sdf_glow_color;\n"
   "\n"
   "in vec4 out_color;\n"
   "in vec2 out_uv;\n"
@@ -929,16 +1929,35 @@ static const char *frame_renderer_fragment_shader_source=
   "void main() {\n"
   "    if(out_uv.x < 0 && out_uv.y < 0) {\n"
   "        fragColor = out_color;\n"
+  "    } else if(out_color.w < 0 && out_uv.y > 1) {\n"
+  "        float d = texture(font_tex, vec2(out_uv.x, 3-out_uv.y)).a;\n"
+  "        float w = fwidth(d) * .5;\n"
+  "        float a = smoothstep(.5 - w, .5 + w, d);\n"
+  "        float o = smoothstep(.5 - sdf_outline - w, .5 - sdf_outline + w, d) * sdf_outline_color.w * float(sdf_outline > 0);\n"
+  "        float g = smoothstep(.5 - sdf_glow, .5, d) * sdf_glow_color.w * float(sdf_glow > 0);\n"
+  "        vec3 rgb = mix(mix(sdf_glow_color.rgb, sdf_outline_color.rgb, o), out_color.rgb, a);\n"
+  "        fragColor = vec4(rgb, max(a, max(o, g)) * -out_color.w);\n"
   "    } else if(out_color.w < 0) {\n"
   "        vec4 color = texture(font_tex, vec2(out_uv.x, 1-out_uv.y));\n"
   "        float a = color.w * -out_color.w;\n"
   "        color = (color + vec4(1, 1, 1, 0)) * out_color;\n"
   "        color.w = a;\n"
   "        fragColor = color;\n"
-  "    } else {\n"
+  "    } else if(tex_yuv == 0) {\n"
   "        vec4 color = texture(tex, vec2(out_uv.x, 1-out_uv.y));\n"
   "        color = color * out_color;\n"
   "        fragColor = color;\n"
+  "    } else {\n"
+  "        vec2 uv = vec2(out_uv.x, 1-out_uv.y);\n"
+  "        vec3 yuv;\n"
+  "        yuv.x = texture(tex, uv).r;\n"
+  "        if(tex_yuv == 1) {\n"
+  "            yuv.yz = texture(tex_u, uv).rg;\n"
+  "        } else {\n"
+  "            yuv.yz = vec2(texture(tex_u, uv).r, texture(tex_v, uv).r);\n"
+  "        }\n"
+  "        vec3 rgb = clamp(yuv_matrix * (yuv - yuv_offset), 0, 1);\n"
+  "        fragColor = vec4(rgb, 1) * out_color;\n"
   "    }\n"
   "}\n";
 
@@ -1005,10 +2024,80 @@ FRAME_DEF bool frame_renderer_init(Frame_Renderer *r) {
   }
   glUseProgram(r->program);
 
-
-  r->images_count = 0;
+  // every sampler has its own unit
+  glUniform1i(glGetUniformLocation(r->program, "tex"), FRAME_RENDERER_TEXTURE_UNIT);
+  glUniform1i(glGetUniformLocation(r->program, "font_tex"), FRAME_RENDERER_FONT_UNIT);
+  glUniform1i(glGetUniformLocation(r->program, "tex_u"), FRAME_RENDERER_YUV_U_UNIT);
+  glUniform1i(glGetUniformLocation(r->program, "tex_v"), FRAME_RENDERER_YUV_V_UNIT);
+
+  r->textures = NULL;
+  r->textures_count = 0;
+  r->textures_cap = 0;
+  r->texture_tick = 0;
+  memset(&r->texture_memory, 0, sizeof(r->texture_memory));
+  r->texture_memory.budget = FRAME_RENDERER_TEXTURE_BUDGET;
+  r->texture_flags = 0;
+  r->max_resident_mip = 0;
+  r->atlas_pages_count = 0;
+  r->pool_started = false;
+  r->upload_budget_ms = FRAME_RENDERER_UPLOAD_BUDGET_MS;
+#ifdef FRAME_STB_IMAGE
+  r->image_cache_dir[0] = 0;
+  r->image_cache_cap = 0;
+  r->image_cache_stored = false;
+  r->image_jobs = 0;
+#endif //FRAME_STB_IMAGE
+#ifdef FRAME_STB_TRUETYPE
+  memset(r->fonts, 0, sizeof(r->fonts));
+  r->font_current = -1;
+  r->font_id = 0;
+  r->font_flags = 0;
+  memset(&r->text_effect, 0, sizeof(r->text_effect));
+  r->glyph_generation = 0;
+  memset(r->text_runs, 0, sizeof(r->text_runs));
+  memset(&r->text_scratch, 0, sizeof(r->text_scratch));
+  r->text_run_tick = 0;
+  memset(&r->text_layout, 0, sizeof(r->text_layout));
+#endif //FRAME_STB_TRUETYPE
   r->verticies_count = 0;
   r->font_index = -1;
+  r->tex_index = -1;
+  r->tex_yuv = FRAME_RENDERER_YUV_NONE;
+  r->tex_yuv_flags = -1;
+
+  r->path_cmds_count = 0;
+  r->path_tick = 0;
+  r->path_points = NULL;
+  r->path_points_count = 0;
+  r->path_points_cap = 0;
+  r->path_contours = NULL;
+  r->path_contours_count = 0;
+  r->path_contours_cap = 0;
+  memset(r->path_cache, 0, sizeof(r->path_cache));
+  glGetIntegerv(GL_STENCIL_BITS, &r->stencil_bits);
+
+  memset(r->targets, 0, sizeof(r->targets));
+  r->target_active = -1;
+
+#ifdef FRAME_STATS
+  memset(&r->stats, 0, sizeof(r->stats));
+  r->stats_history_count = 0;
+  r->stats_history_index = 0;
+#endif //FRAME_STATS
+
+#ifdef FRAME_GPU_TIMER
+  memset(r->gpu_timer_frames, 0, sizeof(r->gpu_timer_frames));
+  for(int i=0;i<FRAME_RENDERER_GPU_TIMER_FRAMES;i++) {
+    Frame_Renderer_Gpu_Timer_Frame *f = &r->gpu_timer_frames[i];
+    glGenQueries(1, &f->clear);
+    glGenQueries(1, &f->swap);
+    glGenQueries(FRAME_RENDERER_GPU_TIMER_BATCHES, f->batches);
+  }
+  r->gpu_timer_index = 0;
+  r->gpu_timer_active = false;
+  r->gpu_timer_frame = 0;
+  r->gpu_timing_valid = false;
+#endif //FRAME_GPU_TIMER
 
   frame_renderer_imgui_end();
   frame_renderer.input = vec2f(-1.f, -1.f);
@@ -1016,86 +2105,544 @@ FRAME_DEF bool frame_renderer_init(Frame_Renderer *r) {
   return true;
 }
 
+FRAME_DEF void frame_renderer_pool_stop();
+FRAME_DEF void frame_renderer_stream_free(Frame_Renderer_Stream *stream);
+FRAME_DEF void frame_renderer_file_unmap(Frame_Renderer_File_Map *map);
+
 FRAME_DEF void frame_renderer_free(Frame_Renderer *r) {
-  (void) r;
-}
+  frame_renderer_pool_stop();
+
+  for(int i=0;i<FRAME_RENDERER_PATH_CACHE_CAP;i++) {
+    free(r->path_cache[i].cmds);
+    free(r->path_cache[i].verticies);
+  }
+  free(r->path_points);
+  free(r->path_contours);
+
+  for(int i=0;i<FRAME_RENDERER_TARGETS_CAP;i++) {
+    Frame_Renderer_Target *t = &r->targets[i];
+    if(!t->created) continue;
+    glDeleteFramebuffers(1, &t->fbo);
+    glDeleteRenderbuffers(1, &t->rbo);
+  }
 
+  for(unsigned int i=0;i<r->textures_count;i++) {
+    Frame_Renderer_Texture *t = &r->textures[i];
+    if(t->name) glDeleteTextures(1, &t->name);
+    if(t->stream) frame_renderer_stream_free(t->stream);
+    if(t->yuv) glDeleteTextures(t->yuv == FRAME_RENDERER_YUV_I420 ? 2 : 1, t->planes);
+    free(t->pixels);
+  }
+  free(r->textures);
+  r->textures = NULL;
+  r->textures_count = 0;
+  r->textures_cap = 0;
+  r->atlas_pages_count = 0;
 
-FRAME_DEF void frame_renderer_begin(int width, int height) {
+#ifdef FRAME_STB_TRUETYPE
+  for(int i=0;i<FRAME_RENDERER_FONTS_CAP;i++) {
+    free(r->fonts[i].data);
+    r->fonts[i].data = NULL;
+    frame_renderer_file_unmap(&r->fonts[i].map);
+    free(r->fonts[i].kerning);
+    r->fonts[i].kerning = NULL;
+    r->fonts[i].used = false;
+  }
+  r->font_current = -1;
+  for(int i=0;i<FRAME_RENDERER_TEXT_RUNS_CAP;i++) {
+    free(r->text_runs[i].verticies);
+    free(r->text_runs[i].shelves);
+  }
+  memset(r->text_runs, 0, sizeof(r->text_runs));
+  free(r->text_scratch.verticies);
+  free(r->text_scratch.shelves);
+  memset(&r->text_scratch, 0, sizeof(r->text_scratch));
+  frame_renderer_text_layout_free(&r->text_layout);
+#endif //FRAME_STB_TRUETYPE
+
+#ifdef FRAME_GPU_TIMER
+  for(int i=0;i<FRAME_RENDERER_GPU_TIMER_FRAMES;i++) {
+    Frame_Renderer_Gpu_Timer_Frame *f = &r->gpu_timer_frames[i];
+    glDeleteQueries(1, &f->clear);
+    glDeleteQueries(1, &f->swap);
+    glDeleteQueries(FRAME_RENDERER_GPU_TIMER_BATCHES, f->batches);
+  }
+#endif //FRAME_GPU_TIMER
+}
 
+FRAME_DEF void frame_renderer_resolution(float width, float height) {
   Frame_Renderer *r = &frame_renderer;
+  
+  glUniform1fv(glGetUniformLocation(r->program, "resolution_x"), 1, &width);
+  glUniform1fv(glGetUniformLocation(r->program, "resolution_y"), 1, &height);
+  FRAME_RENDERER_STAT(uniform_updates, 2);
+}
 
-  if(width > 0 && height > 0) {
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_BLEND);
-    
-    glViewport(0, 0, width, height);
-    glClear(GL_COLOR_BUFFER_BIT);
-    Frame_Renderer_Vec4f *c = &r->background;
-    glClearColor(c->x, c->y, c->z, c->w);
+#ifdef FRAME_GPU_TIMER
+#include <stdio.h>
 
-    // tell vertex shader what is the resolution is
-    glUniform1fv(glGetUniformLocation(r->program, "resolution_x"), 1, &r->width);
-    glUniform1fv(glGetUniformLocation(r->program, "resolution_y"), 1, &r->height);
+FRAME_DEF void frame_renderer_gpu_timer_begin(Frame_Renderer_Gpu_Timer_Kind kind) {
+  Frame_Renderer *r = &frame_renderer;
+  Frame_Renderer_Gpu_Timer_Frame *f = &r->gpu_timer_frames[r->gpu_timer_index];
 
-    r->width = (float) width;
-    r->height = (float) height;
+  if(r->gpu_timer_active) {
+    return;
   }
 
-
-  if(r->font_index > 0) {
-    GLint uniformLocation1 = glGetUniformLocation(r->program, "font_tex");
-    glUniform1i(uniformLocation1, r->font_index);	
+  GLuint query;
+  switch(kind) {
+  case FRAME_RENDERER_GPU_TIMER_CLEAR:
+    query = f->clear;
+    f->clear_issued = true;
+    break;
+  case FRAME_RENDERER_GPU_TIMER_SWAP:
+    query = f->swap;
+    f->swap_issued = true;
+    break;
+  default:
+    if(f->batches_count >= FRAME_RENDERER_GPU_TIMER_BATCHES) {
+      return;
+    }
+    query = f->batches[f->batches_count++];
+    break;
   }
 
-  r->tex_index = -1;  
+  glBeginQuery(GL_TIME_ELAPSED, query);
+  r->gpu_timer_active = true;
 }
 
-FRAME_DEF void frame_renderer_imgui_begin(Frame *w, Frame_Event *e) {
-
-  (void) e;
-  float x, y;
-  frame_get_mouse_position(w, &x, &y);
+FRAME_DEF void frame_renderer_gpu_timer_end() {
+  Frame_Renderer *r = &frame_renderer;
 
-  frame_renderer.pos = frame_renderer_vec2f((float) x, ((float) y));
-  if(frame_renderer.clicked) {
-    frame_renderer.input = frame_renderer.pos;
+  if(!r->gpu_timer_active) {
+    return;
   }
+  glEndQuery(GL_TIME_ELAPSED);
+  r->gpu_timer_active = false;
 }
 
-FRAME_DEF void frame_renderer_imgui_update(Frame *w, Frame_Event *e) {
-  (void) w;
-  if(e->type == FRAME_EVENT_MOUSEPRESS) {    
-    frame_renderer.clicked = true;
-  } else if(e->type == FRAME_EVENT_MOUSERELEASE) {
-    frame_renderer.released = true;
-  }  
+FRAME_DEF double frame_renderer_gpu_timer_ms(GLuint query) {
+  GLuint64 ns = 0;
+  glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+  return (double) ns / 1000000.0;
 }
 
-FRAME_DEF void frame_renderer_imgui_end(Frame *w, Frame_Event *e) {
-  (void) w;
-  (void) e;
-  if(frame_renderer.released) {
-    frame_renderer.input = vec2f(-1.f, -1.f);
-  }
+// Collects the oldest frame of the ring, if the gpu is done with it, and starts a new one
+FRAME_DEF void frame_renderer_gpu_timer_frame() {
+  Frame_Renderer *r = &frame_renderer;
+
+  r->gpu_timer_index = (r->gpu_timer_index + 1) % FRAME_RENDERER_GPU_TIMER_FRAMES;
+  Frame_Renderer_Gpu_Timer_Frame *f = &r->gpu_timer_frames[r->gpu_timer_index];
+
+  if(f->swap_issued) {
+    // queries finish in order, so the swap being available means the frame is
+    GLint available = 0;
+    glGetQueryObjectiv(f->swap, GL_QUERY_RESULT_AVAILABLE, &available);
     
-  frame_renderer.clicked = false;
-  frame_renderer.released = false;
-}
+    if(available) {
+      Frame_Renderer_Gpu_Timing *t = &r->gpu_timing;
+      t->clear_ms = f->clear_issued ? frame_renderer_gpu_timer_ms(f->clear) : 0;
+      t->swap_ms = frame_renderer_gpu_timer_ms(f->swap);
+      t->total_ms = t->clear_ms + t->swap_ms;
+      t->batches_count = f->batches_count;
+      for(int i=0;i<f->batches_count;i++) {
+	t->batches_ms[i] = frame_renderer_gpu_timer_ms(f->batches[i]);
+	t->total_ms += t->batches_ms[i];
+      }
+      t->frame = f->frame;
+      r->gpu_timing_valid = true;
+    }
+  }
 
-FRAME_DEF void frame_renderer_end() {
-  Frame_Renderer *r = &frame_renderer;
-  
-  glBufferSubData(GL_ARRAY_BUFFER, 0, r->verticies_count * sizeof(Frame_Renderer_Vertex), r->verticies);
-  glDrawArrays(GL_TRIANGLES, 0, r->verticies_count);
-  r->verticies_count = 0;
+  f->clear_issued = false;
+  f->swap_issued = false;
+  f->batches_count = 0;
+  f->frame = r->gpu_timer_frame++;
 }
 
-FRAME_DEF void frame_renderer_set_color(Frame_Renderer_Vec4f color) {
+FRAME_DEF bool frame_renderer_gpu_timing(Frame_Renderer_Gpu_Timing *timing) {
   Frame_Renderer *r = &frame_renderer;
-  r->background = color;
-}
+
+  if(!r->gpu_timing_valid) {
+    return false;
+  }
+  *timing = r->gpu_timing;
+  return true;
+}
+
+FRAME_DEF void frame_renderer_gpu_overlay(Frame_Renderer_Vec2f pos, float scale) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(!r->gpu_timing_valid) {
+    return;
+  }
+  Frame_Renderer_Gpu_Timing t = r->gpu_timing;
+
+  // one bar, 1 ms is 40px: clear, batches, swap
+  float px_per_ms = 40.0f * scale;
+  float height = 12.0f * scale;
+  float budget = 1000.0f / 60.0f * px_per_ms;
+
+  frame_renderer_solid_rect(pos, vec2f(budget, height), vec4f(0, 0, 0, .5f));
+
+  float x = pos.x;
+  frame_renderer_solid_rect(vec2f(x, pos.y), vec2f((float) t.clear_ms * px_per_ms, height), vec4f(.6f, .6f, .6f, 1));
+  x += (float) t.clear_ms * px_per_ms;
+  for(int i=0;i<t.batches_count;i++) {
+    Frame_Renderer_Vec4f c = (i % 2) ? vec4f(1, .5f, 0, 1) : vec4f(1, .8f, 0, 1);
+    frame_renderer_solid_rect(vec2f(x, pos.y), vec2f((float) t.batches_ms[i] * px_per_ms, height), c);
+    x += (float) t.batches_ms[i] * px_per_ms;
+  }
+  frame_renderer_solid_rect(vec2f(x, pos.y), vec2f((float) t.swap_ms * px_per_ms, height), vec4f(0, .5f, 1, 1));
+
+  // 60 fps budget
+  frame_renderer_solid_rect(vec2f(pos.x + budget, pos.y - height / 2), vec2f(scale, height * 2), WHITE);
+
+#ifdef FRAME_STB_TRUETYPE
+  if(r->font_current >= 0) {
+    char buf[64];
+    int n = snprintf(buf, sizeof(buf), "gpu %.2f ms (%d batches)", t.total_ms, t.batches_count);
+    frame_renderer_text(buf, (size_t) n, vec2f(pos.x, pos.y + height * 1.5f), .3f * scale, WHITE);
+  }
+#endif //FRAME_STB_TRUETYPE
+}
+
+#endif //FRAME_GPU_TIMER
+
+#ifdef FRAME_STATS
+
+FRAME_DEF void frame_renderer_stats_commit() {
+  Frame_Renderer *r = &frame_renderer;
+
+  r->stats_history[r->stats_history_index] = r->stats;
+  r->stats_history_index = (r->stats_history_index + 1) % FRAME_RENDERER_STATS_HISTORY;
+  if(r->stats_history_count < FRAME_RENDERER_STATS_HISTORY) {
+    r->stats_history_count++;
+  }
+
+  unsigned long long frame = r->stats.frame;
+  memset(&r->stats, 0, sizeof(r->stats));
+  r->stats.frame = frame + 1;
+}
+
+FRAME_DEF bool frame_renderer_stats(Frame_Renderer_Stats *stats) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(r->stats_history_count == 0) {
+    return false;
+  }
+
+  int last = (r->stats_history_index + FRAME_RENDERER_STATS_HISTORY - 1) % FRAME_RENDERER_STATS_HISTORY;
+  *stats = r->stats_history[last];
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_stats_sum(Frame_Renderer_Stats *sum, int *frames) {
+  Frame_Renderer *r = &frame_renderer;
+
+  memset(sum, 0, sizeof(*sum));
+  *frames = r->stats_history_count;
+  if(r->stats_history_count == 0) {
+    return false;
+  }
+
+  for(int i=0;i<r->stats_history_count;i++) {
+    Frame_Renderer_Stats *s = &r->stats_history[i];
+    sum->draw_calls += s->draw_calls;
+    sum->verticies += s->verticies;
+    sum->bytes_uploaded += s->bytes_uploaded;
+    sum->texture_binds += s->texture_binds;
+    sum->uniform_updates += s->uniform_updates;
+    sum->text_runs += s->text_runs;
+    sum->text_run_hits += s->text_run_hits;
+    for(int j=0;j<FRAME_RENDERER_FLUSH_COUNT;j++) {
+      sum->flushes[j] += s->flushes[j];
+    }
+    if(s->frame > sum->frame) {
+      sum->frame = s->frame;
+    }
+  }
+
+  return true;
+}
+
+#endif //FRAME_STATS
+
+FRAME_DEF DWORD WINAPI frame_renderer_pool_worker(LPVOID param) {
+  Frame_Renderer_Pool *pool = (Frame_Renderer_Pool *) param;
+
+  EnterCriticalSection(&pool->lock);
+  while(true) {
+    while(!pool->stop && !pool->queue_first) {
+      SleepConditionVariableCS(&pool->wake, &pool->lock, INFINITE);
+    }
+    if(pool->stop) {
+      break;
+    }
+
+    Frame_Renderer_Work *work = pool->queue_first;
+    pool->queue_first = work->next;
+    if(!pool->queue_first) pool->queue_last = NULL;
+    LeaveCriticalSection(&pool->lock);
+
+    if(!work->cancelled) {
+      work->run(work);
+    }
+
+    EnterCriticalSection(&pool->lock);
+    work->next = NULL;
+    if(pool->finished_last) pool->finished_last->next = work;
+    else pool->finished_first = work;
+    pool->finished_last = work;
+  }
+  LeaveCriticalSection(&pool->lock);
+
+  return 0;
+}
+
+FRAME_DEF bool frame_renderer_pool_start() {
+  Frame_Renderer *r = &frame_renderer;
+  Frame_Renderer_Pool *pool = &r->pool;
+
+  if(r->pool_started) {
+    return true;
+  }
+
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  int count = (int) info.dwNumberOfProcessors - 1; // one is left to the gl thread
+  if(count < 1) count = 1;
+  if(count > FRAME_RENDERER_WORKERS_CAP) count = FRAME_RENDERER_WORKERS_CAP;
+
+  memset(pool, 0, sizeof(*pool));
+  InitializeCriticalSection(&pool->lock);
+  InitializeConditionVariable(&pool->wake);
+
+  for(int i=0;i<count;i++) {
+    HANDLE thread = CreateThread(NULL, 0, frame_renderer_pool_worker, pool, 0, NULL);
+    if(!thread) break;
+    pool->threads[pool->threads_count++] = thread;
+  }
+  if(pool->threads_count == 0) {
+    FRAME_LOG("Can not create worker threads\n");
+    DeleteCriticalSection(&pool->lock);
+    return false;
+  }
+
+  r->pool_started = true;
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_pool_submit(Frame_Renderer_Work *work) {
+  Frame_Renderer_Pool *pool = &frame_renderer.pool;
+
+  if(!frame_renderer_pool_start()) {
+    return false;
+  }
+
+  work->cancelled = false;
+  work->next = NULL;
+  EnterCriticalSection(&pool->lock);
+  if(pool->queue_last) pool->queue_last->next = work;
+  else pool->queue_first = work;
+  pool->queue_last = work;
+  LeaveCriticalSection(&pool->lock);
+  WakeConditionVariable(&pool->wake);
+
+  return true;
+}
+
+// finishes work until the upload budget is spent, but at least one per frame
+FRAME_DEF void frame_renderer_pool_finish() {
+  Frame_Renderer *r = &frame_renderer;
+  Frame_Renderer_Pool *pool = &r->pool;
+
+  if(!r->pool_started) {
+    return;
+  }
+
+  LARGE_INTEGER frequency, start, now;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&start);
+
+  while(true) {
+    EnterCriticalSection(&pool->lock);
+    Frame_Renderer_Work *work = pool->finished_first;
+    if(work) {
+      pool->finished_first = work->next;
+      if(!pool->finished_first) pool->finished_last = NULL;
+    }
+    LeaveCriticalSection(&pool->lock);
+    if(!work) {
+      break;
+    }
+
+    work->finish(work);
+
+    QueryPerformanceCounter(&now);
+    float ms = (float) (now.QuadPart - start.QuadPart) * 1000.0f / (float) frequency.QuadPart;
+    if(ms >= r->upload_budget_ms) {
+      break;
+    }
+  }
+}
+
+FRAME_DEF void frame_renderer_pool_stop() {
+  Frame_Renderer *r = &frame_renderer;
+  Frame_Renderer_Pool *pool = &r->pool;
+
+  if(!r->pool_started) {
+    return;
+  }
+
+  EnterCriticalSection(&pool->lock);
+  pool->stop = true;
+  LeaveCriticalSection(&pool->lock);
+  WakeAllConditionVariable(&pool->wake);
+
+  WaitForMultipleObjects((DWORD) pool->threads_count, pool->threads, TRUE, INFINITE);
+  for(int i=0;i<pool->threads_count;i++) {
+    CloseHandle(pool->threads[i]);
+  }
+  DeleteCriticalSection(&pool->lock);
+  r->pool_started = false;
+
+  // work that never ran, or never came back
+  Frame_Renderer_Work *lists[2] = {pool->queue_first, pool->finished_first};
+  for(int i=0;i<2;i++) {
+    Frame_Renderer_Work *work = lists[i];
+    while(work) {
+      Frame_Renderer_Work *next = work->next;
+      work->cancelled = true;
+      work->finish(work);
+      work = next;
+    }
+  }
+  pool->queue_first = pool->queue_last = NULL;
+  pool->finished_first = pool->finished_last = NULL;
+}
+
+FRAME_DEF void frame_renderer_set_upload_budget(float ms) {
+  frame_renderer.upload_budget_ms = ms;
+}
+
+FRAME_DEF void frame_renderer_texture_reserve(size_t bytes);
+#ifdef FRAME_STB_IMAGE
+FRAME_DEF void frame_renderer_image_cache_update();
+#endif //FRAME_STB_IMAGE
+
+FRAME_DEF void frame_renderer_begin(int width, int height) {
+
+  Frame_Renderer *r = &frame_renderer;
+
+#ifdef FRAME_STATS
+  frame_renderer_stats_commit();
+#endif //FRAME_STATS
+
+  if(width > 0 && height > 0) {
+
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_BLEND);
+    
+    glViewport(0, 0, width, height);
+#ifdef FRAME_GPU_TIMER
+    frame_renderer_gpu_timer_frame();
+#endif //FRAME_GPU_TIMER
+    FRAME_RENDERER_GPU_TIMER_BEGIN(FRAME_RENDERER_GPU_TIMER_CLEAR);
+    glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    FRAME_RENDERER_GPU_TIMER_END();
+    Frame_Renderer_Vec4f *c = &r->background;
+    glClearColor(c->x, c->y, c->z, c->w);
+
+    r->width = (float) width;
+    r->height = (float) height;
+
+    // tell vertex shader what is the resolution is
+    frame_renderer_resolution(r->width, r->height);
+  }
+
+  // a lowered budget, or textures that were only used in earlier frames
+  r->texture_tick++;
+  frame_renderer_texture_reserve(0);
+
+  frame_renderer_pool_finish();
+#ifdef FRAME_STB_IMAGE
+  frame_renderer_image_cache_update();
+#endif //FRAME_STB_IMAGE
+}
+
+FRAME_DEF void frame_renderer_imgui_begin(Frame *w, Frame_Event *e) {
+
+  (void) e;
+  FRAME_TRACE_BEGIN("frame_renderer_imgui_begin");
+  float x, y;
+  frame_get_mouse_position(w, &x, &y);
+
+  frame_renderer.pos = frame_renderer_vec2f((float) x, ((float) y));
+  if(frame_renderer.clicked) {
+    frame_renderer.input = frame_renderer.pos;
+  }
+  FRAME_TRACE_END();
+}
+
+FRAME_DEF void frame_renderer_imgui_update(Frame *w, Frame_Event *e) {
+  (void) w;
+  FRAME_TRACE_BEGIN("frame_renderer_imgui_update");
+  if(e->type == FRAME_EVENT_MOUSEPRESS) {    
+    frame_renderer.clicked = true;
+  } else if(e->type == FRAME_EVENT_MOUSERELEASE) {
+    frame_renderer.released = true;
+  }  
+  FRAME_TRACE_END();
+}
+
+FRAME_DEF void frame_renderer_imgui_end(Frame *w, Frame_Event *e) {
+  (void) w;
+  (void) e;
+  FRAME_TRACE_BEGIN("frame_renderer_imgui_end");
+  if(frame_renderer.released) {
+    frame_renderer.input = vec2f(-1.f, -1.f);
+  }
+    
+  frame_renderer.clicked = false;
+  frame_renderer.released = false;
+  FRAME_TRACE_END();
+}
+
+FRAME_DEF void frame_renderer_flush(Frame_Renderer_Flush_Reason reason) {
+  Frame_Renderer *r = &frame_renderer;
+  (void) reason;
+
+  if(r->verticies_count == 0) {
+    return;
+  }
+
+  FRAME_RENDERER_STAT(flushes[reason], 1);
+  FRAME_RENDERER_STAT(draw_calls, 1);
+  FRAME_RENDERER_STAT(verticies, r->verticies_count);
+  FRAME_RENDERER_STAT(bytes_uploaded, r->verticies_count * sizeof(Frame_Renderer_Vertex));
+  
+  FRAME_TRACE_BEGIN("frame_renderer_upload");
+  glBufferSubData(GL_ARRAY_BUFFER, 0, r->verticies_count * sizeof(Frame_Renderer_Vertex), r->verticies);
+  FRAME_TRACE_END();
+  
+  FRAME_TRACE_BEGIN("frame_renderer_draw");
+  FRAME_RENDERER_GPU_TIMER_BEGIN(FRAME_RENDERER_GPU_TIMER_BATCH);
+  glDrawArrays(GL_TRIANGLES, 0, r->verticies_count);
+  FRAME_RENDERER_GPU_TIMER_END();
+  FRAME_TRACE_END();
+  r->verticies_count = 0;
+}
+
+FRAME_DEF void frame_renderer_end() {
+  frame_renderer_flush(FRAME_RENDERER_FLUSH_END);
+}
+
+FRAME_DEF void frame_renderer_set_color(Frame_Renderer_Vec4f color) {
+  Frame_Renderer *r = &frame_renderer;
+  r->background = color;
+}
 
 FRAME_DEF void frame_renderer_vertex(Frame_Renderer_Vec2f p, Frame_Renderer_Vec4f c, Frame_Renderer_Vec2f uv) {
 
@@ -1115,7 +2662,7 @@ FRAME_DEF void frame_renderer_triangle(Frame_Renderer_Vec2f p1, Frame_Renderer_V
   Frame_Renderer *r = &frame_renderer;
 
   if(r->verticies_count + 3 >= FRAME_RENDERER_CAP) {
-    frame_renderer_end();
+    frame_renderer_flush(FRAME_RENDERER_FLUSH_CAPACITY);
   }
     
   frame_renderer_vertex(p1, c1, uv1);
@@ -1128,7 +2675,7 @@ FRAME_DEF void frame_renderer_solid_triangle(Frame_Renderer_Vec2f p1, Frame_Rend
   Frame_Renderer *r = &frame_renderer;
 
   if(r->verticies_count + 3 >= FRAME_RENDERER_CAP) {
-    frame_renderer_end();
+    frame_renderer_flush(FRAME_RENDERER_FLUSH_CAPACITY);
   }
 	
   Frame_Renderer_Vec2f uv = frame_renderer_vec2f(-1, -1);
@@ -1311,76 +2858,495 @@ FRAME_DEF void frame_renderer_solid_rect_angle(Frame_Renderer_Vec2f pos, Frame_R
 			   color, color, color, uv, uv, uv);
 }
 
-FRAME_DEF void frame_renderer_texture(unsigned int texture,
-					Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s,
-					Frame_Renderer_Vec2f uvp, Frame_Renderer_Vec2f uvs) {
+FRAME_DEF void frame_renderer_texture_format(bool grey, GLenum *format, GLenum *type) {
+  if(grey) {
+    *format = GL_ALPHA;
+    *type = GL_UNSIGNED_BYTE;
+  } else {
+    *format = GL_RGBA;
+    *type = GL_UNSIGNED_INT_8_8_8_8_REV;
+  }
+}
 
+FRAME_DEF bool frame_renderer_texture_evict(unsigned int texture) {
   Frame_Renderer *r = &frame_renderer;
+  Frame_Renderer_Texture *t = &r->textures[texture];
 
-  if(r->tex_index != -1) {
-    frame_renderer_end();
+  unsigned char *pixels = (unsigned char *) malloc(t->bytes);
+  if(!pixels) {
+    return false;
   }
 
-  r->tex_index = (int) texture;
-  GLint uniformLocation1 = glGetUniformLocation(r->program, "tex");
-  glUniform1i(uniformLocation1, r->tex_index);
-    
-  Vec4f c = vec4f(1, 1, 1, 1);
-  frame_renderer_quad(p,
-		       frame_renderer_vec2f(p.x + s.x, p.y),
-		       frame_renderer_vec2f(p.x, p.y + s.y),
-		       frame_renderer_vec2f(p.x + s.x, p.y + s.y),
-		       c, c, c, c,
-		       uvp,
-		       frame_renderer_vec2f(uvp.x + uvs.x, uvp.y),
-		       frame_renderer_vec2f(uvp.x, uvp.y + uvs.y),
-		       frame_renderer_vec2f(uvp.x + uvs.x, uvp.y + uvs.y));
+  GLenum format, type;
+  frame_renderer_texture_format(t->grey, &format, &type);
+  glActiveTexture(GL_TEXTURE0 + FRAME_RENDERER_UPLOAD_UNIT);
+  glBindTexture(GL_TEXTURE_2D, t->name);
+  FRAME_RENDERER_STAT(texture_binds, 1);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glGetTexImage(GL_TEXTURE_2D, 0, format, type, pixels);
+
+  glDeleteTextures(1, &t->name);
+  t->name = 0;
+  t->pixels = pixels;
+  if(r->tex_index == (int) texture) {
+    r->tex_index = -1;
+  }
+
+  Frame_Renderer_Texture_Memory *m = &r->texture_memory;
+  m->resident_bytes -= t->bytes;
+  m->resident--;
+  m->evicted_bytes += t->bytes;
+  m->evicted++;
+  m->evictions++;
+
+  return true;
 }
 
-FRAME_DEF void frame_renderer_texture_colored(unsigned int texture,
-						Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s,
-					        Frame_Renderer_Vec2f uvp, Frame_Renderer_Vec2f uvs,
-						Frame_Renderer_Vec4f c) {
+// evict until 'bytes' more fit into the budget
+FRAME_DEF void frame_renderer_texture_reserve(size_t bytes) {
   Frame_Renderer *r = &frame_renderer;
-  
-  if(r->tex_index != -1) {
-    frame_renderer_end();
+  Frame_Renderer_Texture_Memory *m = &r->texture_memory;
+
+  while(m->resident_bytes + bytes > m->budget) {
+    int lru = -1;
+    for(unsigned int i=0;i<r->textures_count;i++) {
+      Frame_Renderer_Texture *t = &r->textures[i];
+      if(!t->used || !t->name || t->pinned) continue;
+      if(t->last_used >= r->texture_tick) continue; // still drawn in this frame
+      if(lru < 0 || t->last_used < r->textures[lru].last_used) lru = (int) i;
+    }
+    
+    if(lru < 0 || !frame_renderer_texture_evict((unsigned int) lru)) {
+      return;
+    }
   }
-
-  r->tex_index = (int) texture;
-  GLint uniformLocation1 = glGetUniformLocation(r->program, "tex");
-  glUniform1i(uniformLocation1, r->tex_index);
-  
-  frame_renderer_quad(
-		       p,
-		       frame_renderer_vec2f(p.x + s.x, p.y),
-		       frame_renderer_vec2f(p.x, p.y + s.y),
-		       frame_renderer_vec2f(p.x + s.x, p.y + s.y),
-		       c, c, c, c,
-		       uvp,
-		       frame_renderer_vec2f(uvp.x + uvs.x, uvp.y),
-		       frame_renderer_vec2f(uvp.x, uvp.y + uvs.y),
-		       frame_renderer_vec2f(uvp.x + uvs.x, uvp.y + uvs.y));
 }
 
+FRAME_DEF int frame_renderer_mip_size(int size, int level) {
+  size >>= level;
+  return size > 0 ? size : 1;
+}
 
-FRAME_DEF void frame_renderer_solid_circle(Frame_Renderer_Vec2f pos,
-					     float start_angle, float end_angle,
-					     float radius,
-					     int parts,
-					     Frame_Renderer_Vec4f color) {
-  float P = end_angle - start_angle;
-  float A = start_angle;
-
-  Frame_Renderer_Vec2f old = {radius * cosf(A),
-			       radius * sinf(A)};
+FRAME_DEF int frame_renderer_mip_levels(int width, int height) {
+  int levels = 1;
+  while(width > 1 || height > 1) {
+    width = frame_renderer_mip_size(width, 1);
+    height = frame_renderer_mip_size(height, 1);
+    levels++;
+  }
+  return levels;
+}
 
-  float t = 0.0f;
-  float dt = 1.f / (float) parts;
+FRAME_DEF size_t frame_renderer_mip_bytes(int width, int height, int channels, int levels) {
+  size_t bytes = 0;
+  for(int i=0;i<levels;i++) {
+    bytes += (size_t) frame_renderer_mip_size(width, i) * frame_renderer_mip_size(height, i) * channels;
+  }
+  return bytes;
+}
 
-  for(int j=1;j<=parts;j++) {
-    t += dt;
-    Frame_Renderer_Vec2f new = {radius * cosf(A + P * t),
+// 2x2 box filter into a (width/2, height/2) image. Of an odd size the last row or column
+// averages the one left over as well, 3 source texels instead of 2.
+FRAME_DEF void frame_renderer_mip_downsample(const unsigned char *src, int width, int height, int channels, unsigned char *dst) {
+  int dst_width = frame_renderer_mip_size(width, 1);
+  int dst_height = frame_renderer_mip_size(height, 1);
+  size_t src_stride = (size_t) width * channels;
+  int odd_width = width > 1 && (width & 1);
+  int odd_height = height > 1 && (height & 1);
+
+  for(int y=0;y<dst_height;y++) {
+    const unsigned char *row0 = src + (size_t) (2 * y) * src_stride;
+    int rows = (2 * y + 1 < height) ? 2 : 1;
+    if(y == dst_height - 1 && odd_height) rows = 3;
+    unsigned char *out = dst + (size_t) y * dst_width * channels;
+    int x = 0;
+
+#ifdef FRAME_SSE2
+    if(channels == 4 && width > 1 && rows == 2) {
+      // 4 source pixels of both rows into 2 pixels
+      const unsigned char *row1 = row0 + src_stride;
+      __m128i zero = _mm_setzero_si128();
+      __m128i two = _mm_set1_epi16(2);
+      for(;x+2<=dst_width-odd_width;x+=2) {
+	__m128i a = _mm_loadu_si128((const __m128i *) (row0 + x * 8));
+	__m128i b = _mm_loadu_si128((const __m128i *) (row1 + x * 8));
+	__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+	__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+	lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+	hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+	__m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), two), 2);
+	_mm_storel_epi64((__m128i *) (out + x * 4), _mm_packus_epi16(sum, zero));
+      }
+    }
+#endif //FRAME_SSE2
+
+    for(;x<dst_width;x++) {
+      int x0 = 2 * x;
+      int cols = (x0 + 1 < width) ? 2 : 1;
+      if(x == dst_width - 1 && odd_width) cols = 3;
+      int count = rows * cols;
+      for(int c=0;c<channels;c++) {
+	int sum = 0;
+	for(int i=0;i<rows;i++) {
+	  const unsigned char *in = row0 + (size_t) i * src_stride + x0 * channels + c;
+	  for(int j=0;j<cols;j++) {
+	    sum += in[j * channels];
+	  }
+	}
+	out[x * channels + c] = (unsigned char) ((sum + count / 2) / count);
+      }
+    }
+  }
+}
+
+// level 'level' of the image, in a new buffer
+FRAME_DEF unsigned char *frame_renderer_mip_reduce(const unsigned char *data, int width, int height, int channels, int level) {
+  unsigned char *scratch = (unsigned char *) malloc(frame_renderer_mip_bytes(width, height, channels, level + 1));
+  if(!scratch) {
+    return NULL;
+  }
+
+  // levels are written one after another, the last one is moved to the front
+  const unsigned char *src = data;
+  unsigned char *dst = scratch;
+  for(int i=0;i<level;i++) {
+    frame_renderer_mip_downsample(src, width, height, channels, dst);
+    src = dst;
+    dst += (size_t) frame_renderer_mip_size(width, 1) * frame_renderer_mip_size(height, 1) * channels;
+    width = frame_renderer_mip_size(width, 1);
+    height = frame_renderer_mip_size(height, 1);
+  }
+  memmove(scratch, src, (size_t) width * height * channels);
+
+  return scratch;
+}
+
+// levels 1.. of the texture bound on the upload unit, from level 0 in 'data'
+FRAME_DEF bool frame_renderer_texture_upload_mips(Frame_Renderer_Texture *t, const unsigned char *data) {
+  int channels = t->grey ? 1 : 4;
+  GLenum format, type;
+  frame_renderer_texture_format(t->grey, &format, &type);
+
+  unsigned char *scratch = NULL;
+  if(data) {
+    scratch = (unsigned char *) malloc(t->bytes - (size_t) t->width * t->height * channels);
+    if(!scratch) {
+      FRAME_LOG("Can not allocate enough memory\n");
+      return false;
+    }
+  }
+
+  const unsigned char *src = data;
+  unsigned char *dst = scratch;
+  int width = t->width;
+  int height = t->height;
+  for(int level=1;level<t->levels;level++) {
+    if(data) {
+      frame_renderer_mip_downsample(src, width, height, channels, dst);
+    }
+    width = frame_renderer_mip_size(width, 1);
+    height = frame_renderer_mip_size(height, 1);
+
+    glTexImage2D(GL_TEXTURE_2D, level, format, width, height, 0, format, type, data ? dst : NULL);
+    if(data) {
+      FRAME_RENDERER_STAT(bytes_uploaded, (size_t) width * height * channels);
+      src = dst;
+      dst += (size_t) width * height * channels;
+    }
+  }
+
+  free(scratch);
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_texture_upload(unsigned int texture, const void *data) {
+  Frame_Renderer *r = &frame_renderer;
+
+  frame_renderer_texture_reserve(r->textures[texture].bytes);
+  Frame_Renderer_Texture *t = &r->textures[texture];
+
+  glActiveTexture(GL_TEXTURE0 + FRAME_RENDERER_UPLOAD_UNIT);
+  glGenTextures(1, &t->name);
+  if(!t->name) {
+    FRAME_LOG("Can not create texture\n");
+    return false;
+  }
+  glBindTexture(GL_TEXTURE_2D, t->name);
+  FRAME_RENDERER_STAT(texture_binds, 1);
+
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  GLenum format, type;
+  frame_renderer_texture_format(t->grey, &format, &type);
+  glTexImage2D(GL_TEXTURE_2D,
+	       0,
+	       format,
+	       t->width,
+	       t->height,
+	       0,
+	       format,
+	       type,
+	       data);
+  if(data) {
+    FRAME_RENDERER_STAT(bytes_uploaded, (size_t) t->width * t->height * (t->grey ? 1 : 4));
+  }
+  
+  if(t->levels > 1) {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, t->levels - 1);
+    if(!frame_renderer_texture_upload_mips(t, (const unsigned char *) data)) {
+      glDeleteTextures(1, &t->name);
+      t->name = 0;
+      return false;
+    }
+  }
+
+  r->texture_memory.resident_bytes += t->bytes;
+  r->texture_memory.resident++;
+  
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_texture_restore(unsigned int texture) {
+  Frame_Renderer *r = &frame_renderer;
+  Frame_Renderer_Texture *t = &r->textures[texture];
+
+  unsigned char *pixels = t->pixels;
+  if(!frame_renderer_texture_upload(texture, pixels)) {
+    return false;
+  }
+  t = &r->textures[texture];
+  t->pixels = NULL;
+  free(pixels);
+
+  Frame_Renderer_Texture_Memory *m = &r->texture_memory;
+  m->evicted_bytes -= t->bytes;
+  m->evicted--;
+  m->restores++;
+  
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_texture_alloc(unsigned int *texture) {
+  Frame_Renderer *r = &frame_renderer;
+
+  for(unsigned int i=0;i<r->textures_count;i++) {
+    if(!r->textures[i].used) {
+      *texture = i;
+      return true;
+    }
+  }
+
+  if(r->textures_count == r->textures_cap) {
+    unsigned int cap = r->textures_cap ? r->textures_cap * 2 : 16;
+    Frame_Renderer_Texture *textures = (Frame_Renderer_Texture *) realloc(r->textures, cap * sizeof(*textures));
+    if(!textures) {
+      FRAME_LOG("Can not allocate enough memory\n");
+      return false;
+    }
+    r->textures = textures;
+    r->textures_cap = cap;
+  }
+
+  *texture = r->textures_count++;
+  return true;
+}
+
+// Tells the shader how to convert, only when it changes
+FRAME_DEF void frame_renderer_yuv_uniforms(Frame_Renderer_Yuv_Format yuv, int flags) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(r->tex_yuv != yuv) {
+    glUniform1i(glGetUniformLocation(r->program, "tex_yuv"), (GLint) yuv);
+    FRAME_RENDERER_STAT(uniform_updates, 1);
+    r->tex_yuv = yuv;
+  }
+  if(yuv == FRAME_RENDERER_YUV_NONE || r->tex_yuv_flags == flags) {
+    return;
+  }
+  r->tex_yuv_flags = flags;
+
+  float kr = .299f, kb = .114f;
+  if(flags & FRAME_RENDERER_YUV_BT709) {
+    kr = .2126f;
+    kb = .0722f;
+  }
+  float kg = 1.0f - kr - kb;
+
+  // limited range is 16..235 for luma and 16..240 for chroma
+  float ys = 1.0f, cs = 1.0f;
+  float offset[3] = {0.0f, 128.0f / 255.0f, 128.0f / 255.0f};
+  if(!(flags & FRAME_RENDERER_YUV_FULL_RANGE)) {
+    ys = 255.0f / 219.0f;
+    cs = 255.0f / 224.0f;
+    offset[0] = 16.0f / 255.0f;
+  }
+
+  // column major, one column per y, u and v
+  float matrix[9] = {
+    ys, ys, ys,
+    0.0f, -cs * 2.0f * kb * (1.0f - kb) / kg, cs * 2.0f * (1.0f - kb),
+    cs * 2.0f * (1.0f - kr), -cs * 2.0f * kr * (1.0f - kr) / kg, 0.0f,
+  };
+  glUniformMatrix3fv(glGetUniformLocation(r->program, "yuv_matrix"), 1, GL_FALSE, matrix);
+  glUniform3fv(glGetUniformLocation(r->program, "yuv_offset"), 1, offset);
+  FRAME_RENDERER_STAT(uniform_updates, 2);
+}
+
+// Binds the texture on its unit, if the batch draws with a different one, it is flushed
+FRAME_DEF bool frame_renderer_texture_use(unsigned int texture) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(texture >= r->textures_count || !r->textures[texture].used) {
+    return false;
+  }
+  if(r->textures[texture].loading || r->textures[texture].failed) {
+    return false;
+  }
+  r->textures[texture].last_used = r->texture_tick;
+  
+  if(r->textures[texture].atlas) {
+    if(r->textures[texture].page < 0) {
+      return false;
+    }
+    texture = r->atlas_pages[r->textures[texture].page].texture;
+    r->textures[texture].last_used = r->texture_tick;
+  }
+
+  if(r->tex_index == (int) texture) {
+    return true;
+  }
+  if(!r->textures[texture].name && !frame_renderer_texture_restore(texture)) {
+    return false;
+  }
+  
+  frame_renderer_flush(FRAME_RENDERER_FLUSH_TEXTURE);
+
+  Frame_Renderer_Texture *t = &r->textures[texture];
+  glActiveTexture(GL_TEXTURE0 + FRAME_RENDERER_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_2D, t->name);
+  FRAME_RENDERER_STAT(texture_binds, 1);
+  if(t->yuv) {
+    glActiveTexture(GL_TEXTURE0 + FRAME_RENDERER_YUV_U_UNIT);
+    glBindTexture(GL_TEXTURE_2D, t->planes[0]);
+    FRAME_RENDERER_STAT(texture_binds, 1);
+    if(t->yuv == FRAME_RENDERER_YUV_I420) {
+      glActiveTexture(GL_TEXTURE0 + FRAME_RENDERER_YUV_V_UNIT);
+      glBindTexture(GL_TEXTURE_2D, t->planes[1]);
+      FRAME_RENDERER_STAT(texture_binds, 1);
+    }
+  }
+  frame_renderer_yuv_uniforms(t->yuv, t->yuv_flags);
+  r->tex_index = (int) texture;
+  
+  return true;
+}
+
+// images that are still loading, or failed to, are drawn as a plain rect
+FRAME_DEF bool frame_renderer_texture_placeholder(unsigned int texture,
+						  Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s,
+						  Frame_Renderer_Vec4f c) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(texture >= r->textures_count || !r->textures[texture].used) {
+    return false;
+  }
+  Frame_Renderer_Texture *t = &r->textures[texture];
+  if(!t->loading && !t->failed) {
+    return false;
+  }
+
+  Frame_Renderer_Vec4f color = FRAME_RENDERER_PLACEHOLDER_COLOR;
+  frame_renderer_solid_rect(p, s, frame_renderer_vec4f(color.x * c.x, color.y * c.y, color.z * c.z, color.w * c.w));
+  return true;
+}
+
+// uv of an atlas image to uv of its page
+FRAME_DEF void frame_renderer_texture_uv(unsigned int texture, Frame_Renderer_Vec2f *uvp, Frame_Renderer_Vec2f *uvs) {
+  Frame_Renderer_Texture *t = &frame_renderer.textures[texture];
+  if(!t->atlas) {
+    return;
+  }
+
+  // the shader samples 1 - v, rows of the image start at t->y
+  float size = (float) FRAME_RENDERER_ATLAS_SIZE;
+  uvp->x = ((float) t->x + uvp->x * (float) t->width) / size;
+  uvp->y = (size - (float) (t->y + t->height) + uvp->y * (float) t->height) / size;
+  uvs->x = uvs->x * (float) t->width / size;
+  uvs->y = uvs->y * (float) t->height / size;
+}
+
+FRAME_DEF void frame_renderer_texture(unsigned int texture,
+					Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s,
+					Frame_Renderer_Vec2f uvp, Frame_Renderer_Vec2f uvs) {
+
+  Vec4f c = vec4f(1, 1, 1, 1);
+  if(frame_renderer_texture_placeholder(texture, p, s, c)) {
+    return;
+  }
+  if(!frame_renderer_texture_use(texture)) {
+    return;
+  }
+  frame_renderer_texture_uv(texture, &uvp, &uvs);
+
+  frame_renderer_quad(p,
+		       frame_renderer_vec2f(p.x + s.x, p.y),
+		       frame_renderer_vec2f(p.x, p.y + s.y),
+		       frame_renderer_vec2f(p.x + s.x, p.y + s.y),
+		       c, c, c, c,
+		       uvp,
+		       frame_renderer_vec2f(uvp.x + uvs.x, uvp.y),
+		       frame_renderer_vec2f(uvp.x, uvp.y + uvs.y),
+		       frame_renderer_vec2f(uvp.x + uvs.x, uvp.y + uvs.y));
+}
+
+FRAME_DEF void frame_renderer_texture_colored(unsigned int texture,
+						Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s,
+					        Frame_Renderer_Vec2f uvp, Frame_Renderer_Vec2f uvs,
+						Frame_Renderer_Vec4f c) {
+  if(frame_renderer_texture_placeholder(texture, p, s, c)) {
+    return;
+  }
+  if(!frame_renderer_texture_use(texture)) {
+    return;
+  }
+  frame_renderer_texture_uv(texture, &uvp, &uvs);
+
+  frame_renderer_quad(
+		       p,
+		       frame_renderer_vec2f(p.x + s.x, p.y),
+		       frame_renderer_vec2f(p.x, p.y + s.y),
+		       frame_renderer_vec2f(p.x + s.x, p.y + s.y),
+		       c, c, c, c,
+		       uvp,
+		       frame_renderer_vec2f(uvp.x + uvs.x, uvp.y),
+		       frame_renderer_vec2f(uvp.x, uvp.y + uvs.y),
+		       frame_renderer_vec2f(uvp.x + uvs.x, uvp.y + uvs.y));
+}
+
+
+FRAME_DEF void frame_renderer_solid_circle(Frame_Renderer_Vec2f pos,
+					     float start_angle, float end_angle,
+					     float radius,
+					     int parts,
+					     Frame_Renderer_Vec4f color) {
+  float P = end_angle - start_angle;
+  float A = start_angle;
+
+  Frame_Renderer_Vec2f old = {radius * cosf(A),
+			       radius * sinf(A)};
+
+  float t = 0.0f;
+  float dt = 1.f / (float) parts;
+
+  for(int j=1;j<=parts;j++) {
+    t += dt;
+    Frame_Renderer_Vec2f new = {radius * cosf(A + P * t),
 				 radius * sinf(A + P * t)};
     frame_renderer_solid_triangle(pos,
 				   frame_renderer_vec2f(pos.x + new.x, pos.y + new.y),
@@ -1389,130 +3355,3615 @@ FRAME_DEF void frame_renderer_solid_circle(Frame_Renderer_Vec2f pos,
     old = new;
   }
 
-  
+  
+}
+
+#define FRAME_RENDERER_HASH_INIT 14695981039346656037ULL
+
+FRAME_DEF unsigned long long frame_renderer_hash(unsigned long long hash, const void *data, size_t size) {
+  const unsigned char *bytes = (const unsigned char *) data;
+  for(size_t i=0;i<size;i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+FRAME_DEF void frame_renderer_path_push(Frame_Renderer_Path_Type type, Frame_Renderer_Vec2f p1, Frame_Renderer_Vec2f p2, Frame_Renderer_Vec2f p3) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(r->path_cmds_count >= FRAME_RENDERER_PATH_CAP) {
+    return;
+  }
+
+  Frame_Renderer_Path_Cmd *cmd = &r->path_cmds[r->path_cmds_count++];
+  cmd->type = type;
+  cmd->p[0] = p1;
+  cmd->p[1] = p2;
+  cmd->p[2] = p3;
+}
+
+FRAME_DEF void frame_renderer_path_begin() {
+  frame_renderer.path_cmds_count = 0;
+}
+
+FRAME_DEF void frame_renderer_path_move_to(Frame_Renderer_Vec2f p) {
+  Vec2f zero = vec2f(0, 0);
+  frame_renderer_path_push(FRAME_RENDERER_PATH_MOVE, p, zero, zero);
+}
+
+FRAME_DEF void frame_renderer_path_line_to(Frame_Renderer_Vec2f p) {
+  Vec2f zero = vec2f(0, 0);
+  frame_renderer_path_push(FRAME_RENDERER_PATH_LINE, p, zero, zero);
+}
+
+FRAME_DEF void frame_renderer_path_quad_to(Frame_Renderer_Vec2f c, Frame_Renderer_Vec2f p) {
+  frame_renderer_path_push(FRAME_RENDERER_PATH_QUAD, c, p, vec2f(0, 0));
+}
+
+FRAME_DEF void frame_renderer_path_cubic_to(Frame_Renderer_Vec2f c1, Frame_Renderer_Vec2f c2, Frame_Renderer_Vec2f p) {
+  frame_renderer_path_push(FRAME_RENDERER_PATH_CUBIC, c1, c2, p);
+}
+
+FRAME_DEF void frame_renderer_path_close() {
+  Vec2f zero = vec2f(0, 0);
+  frame_renderer_path_push(FRAME_RENDERER_PATH_CLOSE, zero, zero, zero);
+}
+
+FRAME_DEF Frame_Renderer_Path_Cmd frame_renderer_path_relative(Frame_Renderer_Path_Cmd *cmd, Frame_Renderer_Vec2f origin) {
+  int n = 0;
+  switch(cmd->type) {
+  case FRAME_RENDERER_PATH_MOVE:
+  case FRAME_RENDERER_PATH_LINE:
+    n = 1;
+    break;
+  case FRAME_RENDERER_PATH_QUAD:
+    n = 2;
+    break;
+  case FRAME_RENDERER_PATH_CUBIC:
+    n = 3;
+    break;
+  default:
+    break;
+  }
+
+  Frame_Renderer_Path_Cmd rel;
+  memset(&rel, 0, sizeof(rel));
+  rel.type = cmd->type;
+  for(int i=0;i<n;i++) {
+    rel.p[i] = vec2f(cmd->p[i].x - origin.x, cmd->p[i].y - origin.y);
+  }
+
+  return rel;
+}
+
+FRAME_DEF void frame_renderer_path_point(Frame_Renderer *r, Frame_Renderer_Vec2f p) {
+  if(r->path_points_count >= r->path_points_cap) {
+    int cap = r->path_points_cap == 0 ? 256 : r->path_points_cap * 2;
+    Frame_Renderer_Vec2f *points = realloc(r->path_points, cap * sizeof(*points));
+    if(!points) {
+      return;
+    }
+    r->path_points = points;
+    r->path_points_cap = cap;
+  }
+
+  r->path_points[r->path_points_count++] = p;
+}
+
+FRAME_DEF void frame_renderer_path_contour(Frame_Renderer *r, Frame_Renderer_Vec2f p) {
+  if(r->path_contours_count >= r->path_contours_cap) {
+    int cap = r->path_contours_cap == 0 ? 16 : r->path_contours_cap * 2;
+    int *contours = realloc(r->path_contours, cap * sizeof(*contours));
+    if(!contours) {
+      return;
+    }
+    r->path_contours = contours;
+    r->path_contours_cap = cap;
+  }
+
+  r->path_contours[r->path_contours_count++] = r->path_points_count;
+  frame_renderer_path_point(r, p);
+}
+
+// Wang's formula: segments needed to keep a curve within the tolerance
+FRAME_DEF int frame_renderer_path_segments(float dd) {
+  int n = (int) ceilf(sqrtf(dd / FRAME_RENDERER_PATH_TOLERANCE));
+  if(n < 1) n = 1;
+  if(n > 256) n = 256;
+  return n;
+}
+
+FRAME_DEF void frame_renderer_path_flatten(Frame_Renderer *r, Frame_Renderer_Path_Cmd *cmds, int cmds_count) {
+  r->path_points_count = 0;
+  r->path_contours_count = 0;
+
+  Frame_Renderer_Vec2f cur = vec2f(0, 0);
+  Frame_Renderer_Vec2f start = vec2f(0, 0);
+  bool open = false;
+  
+  for(int i=0;i<cmds_count;i++) {
+    Frame_Renderer_Path_Cmd *cmd = &cmds[i];
+
+    if(cmd->type == FRAME_RENDERER_PATH_MOVE) {
+      cur = start = cmd->p[0];
+      frame_renderer_path_contour(r, cur);
+      open = true;
+      continue;
+    } else if(cmd->type == FRAME_RENDERER_PATH_CLOSE) {
+      cur = start;
+      open = false;
+      continue;
+    }
+
+    if(!open) {
+      start = cur;
+      frame_renderer_path_contour(r, cur);
+      open = true;
+    }
+
+    switch(cmd->type) {
+    case FRAME_RENDERER_PATH_LINE: {
+      cur = cmd->p[0];
+      frame_renderer_path_point(r, cur);
+    } break;
+    case FRAME_RENDERER_PATH_QUAD: {
+      Frame_Renderer_Vec2f p0 = cur, p1 = cmd->p[0], p2 = cmd->p[1];
+      float ddx = p0.x - 2 * p1.x + p2.x;
+      float ddy = p0.y - 2 * p1.y + p2.y;
+      int n = frame_renderer_path_segments(0.25f * sqrtf(ddx * ddx + ddy * ddy));
+      for(int j=1;j<=n;j++) {
+	float t = (float) j / (float) n;
+	float u = 1 - t;
+	frame_renderer_path_point(r, vec2f(u * u * p0.x + 2 * u * t * p1.x + t * t * p2.x,
+					   u * u * p0.y + 2 * u * t * p1.y + t * t * p2.y));
+      }
+      cur = p2;
+    } break;
+    case FRAME_RENDERER_PATH_CUBIC: {
+      Frame_Renderer_Vec2f p0 = cur, p1 = cmd->p[0], p2 = cmd->p[1], p3 = cmd->p[2];
+      float ddx1 = p0.x - 2 * p1.x + p2.x;
+      float ddy1 = p0.y - 2 * p1.y + p2.y;
+      float ddx2 = p1.x - 2 * p2.x + p3.x;
+      float ddy2 = p1.y - 2 * p2.y + p3.y;
+      float dd1 = ddx1 * ddx1 + ddy1 * ddy1;
+      float dd2 = ddx2 * ddx2 + ddy2 * ddy2;
+      int n = frame_renderer_path_segments(0.75f * sqrtf(dd1 > dd2 ? dd1 : dd2));
+      for(int j=1;j<=n;j++) {
+	float t = (float) j / (float) n;
+	float u = 1 - t;
+	float a = u * u * u, b = 3 * u * u * t, c = 3 * u * t * t, d = t * t * t;
+	frame_renderer_path_point(r, vec2f(a * p0.x + b * p1.x + c * p2.x + d * p3.x,
+					   a * p0.y + b * p1.y + c * p2.y + d * p3.y));
+      }
+      cur = p3;
+    } break;
+    default: {
+    } break;
+    }
+  }
+}
+
+// A simple convex contour turns exactly once, always into the same direction
+FRAME_DEF bool frame_renderer_path_convex(Frame_Renderer_Vec2f *points, int n) {
+  float sign = 0;
+  float turn = 0;
+
+  for(int i=0;i<n;i++) {
+    Frame_Renderer_Vec2f a = points[i];
+    Frame_Renderer_Vec2f b = points[(i + 1) % n];
+    Frame_Renderer_Vec2f c = points[(i + 2) % n];
+
+    float e1x = b.x - a.x, e1y = b.y - a.y;
+    float e2x = c.x - b.x, e2y = c.y - b.y;
+    float cross = e1x * e2y - e1y * e2x;
+    float dot = e1x * e2x + e1y * e2y;
+
+    if(fabsf(cross) > 1e-6f) {
+      if(sign == 0) {
+	sign = cross;
+      } else if((cross > 0) != (sign > 0)) {
+	return false;
+      }
+    }
+    turn += atan2f(cross, dot);
+  }
+
+  return fabsf(turn) < 3 * PI;
+}
+
+FRAME_DEF bool frame_renderer_path_tessellate(Frame_Renderer *r, Frame_Renderer_Path_Entry *entry, unsigned long long hash, Frame_Renderer_Fill_Rule rule, Frame_Renderer_Vec2f origin) {
+  free(entry->cmds);
+  free(entry->verticies);
+  memset(entry, 0, sizeof(*entry));
+
+  entry->cmds = malloc(r->path_cmds_count * sizeof(*entry->cmds));
+  if(!entry->cmds) {
+    return false;
+  }
+  for(int i=0;i<r->path_cmds_count;i++) {
+    entry->cmds[i] = frame_renderer_path_relative(&r->path_cmds[i], origin);
+  }
+  entry->cmds_count = r->path_cmds_count;
+
+  frame_renderer_path_flatten(r, entry->cmds, entry->cmds_count);
+
+  int triangles = 0;
+  int contours = 0;
+  int convex_start = 0, convex_n = 0;
+  for(int i=0;i<r->path_contours_count;i++) {
+    int start = r->path_contours[i];
+    int end = i + 1 < r->path_contours_count ? r->path_contours[i + 1] : r->path_points_count;
+    int n = end - start;
+    if(n < 3) continue;
+
+    triangles += n - 2;
+    contours++;
+    convex_start = start;
+    convex_n = n;
+  }
+
+  entry->verticies = malloc((triangles > 0 ? triangles : 1) * 3 * sizeof(*entry->verticies));
+  if(!entry->verticies) {
+    free(entry->cmds);
+    memset(entry, 0, sizeof(*entry));
+    return false;
+  }
+
+  // a fan per contour, the stencil pass resolves the fill rule
+  Frame_Renderer_Vec2f *v = entry->verticies;
+  for(int i=0;i<r->path_contours_count;i++) {
+    int start = r->path_contours[i];
+    int end = i + 1 < r->path_contours_count ? r->path_contours[i + 1] : r->path_points_count;
+    if(end - start < 3) continue;
+
+    Frame_Renderer_Vec2f *points = r->path_points;
+    for(int j=start+1;j<end-1;j++) {
+      *v++ = points[start];
+      *v++ = points[j];
+      *v++ = points[j + 1];
+    }
+  }
+  entry->verticies_count = triangles * 3;
+
+  entry->min = vec2f(0, 0);
+  entry->max = vec2f(0, 0);
+  for(int i=0;i<entry->verticies_count;i++) {
+    Frame_Renderer_Vec2f p = entry->verticies[i];
+    if(i == 0 || p.x < entry->min.x) entry->min.x = p.x;
+    if(i == 0 || p.y < entry->min.y) entry->min.y = p.y;
+    if(i == 0 || p.x > entry->max.x) entry->max.x = p.x;
+    if(i == 0 || p.y > entry->max.y) entry->max.y = p.y;
+  }
+
+  entry->convex = contours == 1 && frame_renderer_path_convex(r->path_points + convex_start, convex_n);
+  entry->hash = hash;
+  entry->rule = rule;
+
+  return true;
+}
+
+FRAME_DEF Frame_Renderer_Path_Entry *frame_renderer_path_lookup(Frame_Renderer *r, unsigned long long hash, Frame_Renderer_Fill_Rule rule, Frame_Renderer_Vec2f origin) {
+  Frame_Renderer_Path_Entry *lru = &r->path_cache[0];
+  
+  for(int i=0;i<FRAME_RENDERER_PATH_CACHE_CAP;i++) {
+    Frame_Renderer_Path_Entry *entry = &r->path_cache[i];
+
+    if(entry->cmds != NULL &&
+       entry->hash == hash &&
+       entry->rule == rule &&
+       entry->cmds_count == r->path_cmds_count) {
+
+      bool equal = true;
+      for(int j=0;equal && j<entry->cmds_count;j++) {
+	Frame_Renderer_Path_Cmd rel = frame_renderer_path_relative(&r->path_cmds[j], origin);
+	equal = memcmp(&rel, &entry->cmds[j], sizeof(rel)) == 0;
+      }
+      if(equal) {
+	return entry;
+      }
+    }
+
+    if(entry->last_used < lru->last_used) {
+      lru = entry;
+    }
+  }
+
+  if(!frame_renderer_path_tessellate(r, lru, hash, rule, origin)) {
+    return NULL;
+  }
+
+  return lru;
+}
+
+FRAME_DEF void frame_renderer_path_fill(Frame_Renderer_Fill_Rule rule, Frame_Renderer_Vec4f color) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(r->path_cmds_count == 0) {
+    return;
+  }
+
+  Frame_Renderer_Vec2f origin = r->path_cmds[0].p[0];
+  
+  unsigned long long hash = FRAME_RENDERER_HASH_INIT;
+  hash = frame_renderer_hash(hash, &rule, sizeof(rule));
+  for(int i=0;i<r->path_cmds_count;i++) {
+    Frame_Renderer_Path_Cmd rel = frame_renderer_path_relative(&r->path_cmds[i], origin);
+    hash = frame_renderer_hash(hash, &rel, sizeof(rel));
+  }
+
+  Frame_Renderer_Path_Entry *entry = frame_renderer_path_lookup(r, hash, rule, origin);
+  if(entry == NULL || entry->verticies_count == 0) {
+    return;
+  }
+  entry->last_used = ++r->path_tick;
+
+  Frame_Renderer_Vec2f *v = entry->verticies;
+  
+  if(entry->convex || r->stencil_bits <= 0) {
+    for(int i=0;i<entry->verticies_count;i+=3) {
+      frame_renderer_solid_triangle(vec2f(origin.x + v[i].x, origin.y + v[i].y),
+				    vec2f(origin.x + v[i + 1].x, origin.y + v[i + 1].y),
+				    vec2f(origin.x + v[i + 2].x, origin.y + v[i + 2].y),
+				    color);
+    }
+    return;
+  }
+
+  // stencil
+  frame_renderer_flush(FRAME_RENDERER_FLUSH_STATE);
+  glEnable(GL_STENCIL_TEST);
+  glStencilMask(0xff);
+  glStencilFunc(GL_ALWAYS, 0, 0xff);
+  glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+  if(rule == FRAME_RENDERER_FILL_EVENODD) {
+    glStencilOp(GL_KEEP, GL_KEEP, GL_INVERT);
+  } else {
+    glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_INCR_WRAP);
+    glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
+  }
+
+  for(int i=0;i<entry->verticies_count;i+=3) {
+    frame_renderer_solid_triangle(vec2f(origin.x + v[i].x, origin.y + v[i].y),
+				  vec2f(origin.x + v[i + 1].x, origin.y + v[i + 1].y),
+				  vec2f(origin.x + v[i + 2].x, origin.y + v[i + 2].y),
+				  color);
+  }
+  frame_renderer_flush(FRAME_RENDERER_FLUSH_STATE);
+
+  // cover, which also resets the stencil
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  glStencilFunc(GL_NOTEQUAL, 0, 0xff);
+  glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
+  frame_renderer_solid_rect(vec2f(origin.x + entry->min.x, origin.y + entry->min.y),
+			    vec2f(entry->max.x - entry->min.x, entry->max.y - entry->min.y),
+			    color);
+  frame_renderer_flush(FRAME_RENDERER_FLUSH_STATE);
+  glDisable(GL_STENCIL_TEST);
+}
+
+// y at which a rect starting at node 'index' rests, -1 if it does not fit
+FRAME_DEF int frame_renderer_skyline_fit(Frame_Renderer_Atlas_Node *nodes, int count, int index, int width, int height) {
+  if(nodes[index].x + width > FRAME_RENDERER_ATLAS_SIZE) {
+    return -1;
+  }
+
+  int y = 0;
+  int left = width;
+  for(int i=index;left > 0;i++) {
+    if(i >= count) {
+      return -1;
+    }
+    if(nodes[i].y > y) y = nodes[i].y;
+    if(y + height > FRAME_RENDERER_ATLAS_SIZE) {
+      return -1;
+    }
+    left -= nodes[i].width;
+  }
+
+  return y;
+}
+
+// bottom-left: the lowest top edge wins, ties go to the narrower node
+FRAME_DEF bool frame_renderer_skyline_insert(Frame_Renderer_Atlas_Node *nodes, int *count, int width, int height, int *x, int *y) {
+  int best = -1;
+  int best_top = 0;
+  int best_width = 0;
+  for(int i=0;i<*count;i++) {
+    int fy = frame_renderer_skyline_fit(nodes, *count, i, width, height);
+    if(fy < 0) continue;
+    if(best < 0 || fy + height < best_top || (fy + height == best_top && nodes[i].width < best_width)) {
+      best = i;
+      best_top = fy + height;
+      best_width = nodes[i].width;
+    }
+  }
+  if(best < 0 || *count >= FRAME_RENDERER_ATLAS_NODES_CAP) {
+    return false;
+  }
+
+  *x = nodes[best].x;
+  *y = best_top - height;
+  
+  memmove(&nodes[best + 1], &nodes[best], (size_t) (*count - best) * sizeof(*nodes));
+  nodes[best].x = *x;
+  nodes[best].y = best_top;
+  nodes[best].width = width;
+  (*count)++;
+
+  // cut the nodes below the new one
+  for(int i=best+1;i<*count;i++) {
+    Frame_Renderer_Atlas_Node *prev = &nodes[i - 1];
+    Frame_Renderer_Atlas_Node *n = &nodes[i];
+    int overlap = prev->x + prev->width - n->x;
+    if(overlap <= 0) break;
+
+    n->x += overlap;
+    n->width -= overlap;
+    if(n->width > 0) break;
+    
+    memmove(&nodes[i], &nodes[i + 1], (size_t) (*count - i - 1) * sizeof(*nodes));
+    (*count)--;
+    i--;
+  }
+
+  for(int i=0;i<*count - 1;i++) {
+    if(nodes[i].y != nodes[i + 1].y) continue;
+    nodes[i].width += nodes[i + 1].width;
+    memmove(&nodes[i + 1], &nodes[i + 2], (size_t) (*count - i - 2) * sizeof(*nodes));
+    (*count)--;
+    i--;
+  }
+
+  return true;
+}
+
+FRAME_DEF void frame_renderer_atlas_page_clear(Frame_Renderer_Atlas_Page *page) {
+  page->nodes[0].x = 0;
+  page->nodes[0].y = 0;
+  page->nodes[0].width = FRAME_RENDERER_ATLAS_SIZE;
+  page->nodes_count = 1;
+  page->released_area = 0;
+}
+
+// copies the image with its extruded edges onto the page
+FRAME_DEF bool frame_renderer_atlas_upload(unsigned int texture) {
+  Frame_Renderer *r = &frame_renderer;
+  
+  unsigned int page = r->atlas_pages[r->textures[texture].page].texture;
+  if(!r->textures[page].name && !frame_renderer_texture_restore(page)) {
+    return false;
+  }
+  Frame_Renderer_Texture *t = &r->textures[texture];
+
+  int p = FRAME_RENDERER_ATLAS_PADDING;
+  int width = t->width + 2 * p;
+  int height = t->height + 2 * p;
+  unsigned int *padded = (unsigned int *) malloc((size_t) width * height * sizeof(unsigned int));
+  if(!padded) {
+    FRAME_LOG("Can not allocate enough memory\n");
+    return false;
+  }
+
+  unsigned int *pixels = (unsigned int *) t->pixels;
+  for(int y=0;y<height;y++) {
+    int sy = y - p;
+    if(sy < 0) sy = 0;
+    if(sy >= t->height) sy = t->height - 1;
+    for(int x=0;x<width;x++) {
+      int sx = x - p;
+      if(sx < 0) sx = 0;
+      if(sx >= t->width) sx = t->width - 1;
+      padded[y * width + x] = pixels[sy * t->width + sx];
+    }
+  }
+
+  glActiveTexture(GL_TEXTURE0 + FRAME_RENDERER_UPLOAD_UNIT);
+  glBindTexture(GL_TEXTURE_2D, r->textures[page].name);
+  FRAME_RENDERER_STAT(texture_binds, 1);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexSubImage2D(GL_TEXTURE_2D,
+		  0,
+		  t->x - p, t->y - p,
+		  width, height,
+		  GL_RGBA,
+		  GL_UNSIGNED_INT_8_8_8_8_REV,
+		  padded);
+  FRAME_RENDERER_STAT(bytes_uploaded, (size_t) width * height * 4);
+
+  free(padded);
+  return true;
+}
+
+FRAME_DEF int frame_renderer_atlas_compare(const void *a, const void *b) {
+  const Frame_Renderer_Texture *ta = &frame_renderer.textures[*(const unsigned int *) a];
+  const Frame_Renderer_Texture *tb = &frame_renderer.textures[*(const unsigned int *) b];
+  if(ta->height != tb->height) {
+    return tb->height - ta->height;
+  }
+  return tb->width - ta->width;
+}
+
+// Packs all atlas images from scratch, highest first. Nothing moves, if they do not fit.
+FRAME_DEF bool frame_renderer_repack_atlas() {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(r->atlas_pages_count == 0) {
+    return true;
+  }
+  
+  unsigned int count = 0;
+  for(unsigned int i=0;i<r->textures_count;i++) {
+    if(r->textures[i].used && r->textures[i].atlas) count++;
+  }
+
+  unsigned int *order = (unsigned int *) malloc((count + 1) * sizeof(unsigned int));
+  int *places = (int *) malloc((count + 1) * 3 * sizeof(int));
+  Frame_Renderer_Atlas_Page *pages = (Frame_Renderer_Atlas_Page *) malloc(r->atlas_pages_count * sizeof(*pages));
+  if(!order || !places || !pages) {
+    FRAME_LOG("Can not allocate enough memory\n");
+    free(order);
+    free(places);
+    free(pages);
+    return false;
+  }
+
+  count = 0;
+  for(unsigned int i=0;i<r->textures_count;i++) {
+    if(r->textures[i].used && r->textures[i].atlas) order[count++] = i;
+  }
+  qsort(order, count, sizeof(*order), frame_renderer_atlas_compare);
+
+  for(int i=0;i<r->atlas_pages_count;i++) {
+    pages[i].texture = r->atlas_pages[i].texture;
+    frame_renderer_atlas_page_clear(&pages[i]);
+  }
+
+  int p = FRAME_RENDERER_ATLAS_PADDING;
+  bool fits = true;
+  for(unsigned int i=0;fits && i<count;i++) {
+    Frame_Renderer_Texture *t = &r->textures[order[i]];
+    fits = false;
+    for(int j=0;!fits && j<r->atlas_pages_count;j++) {
+      int x, y;
+      if(frame_renderer_skyline_insert(pages[j].nodes, &pages[j].nodes_count, t->width + 2 * p, t->height + 2 * p, &x, &y)) {
+	places[i * 3 + 0] = j;
+	places[i * 3 + 1] = x + p;
+	places[i * 3 + 2] = y + p;
+	fits = true;
+      }
+    }
+  }
+
+  if(fits) {
+    // queued quads still use the old places
+    frame_renderer_flush(FRAME_RENDERER_FLUSH_STATE);
+
+    memcpy(r->atlas_pages, pages, r->atlas_pages_count * sizeof(*pages));
+    for(unsigned int i=0;i<count;i++) {
+      Frame_Renderer_Texture *t = &r->textures[order[i]];
+      t->page = places[i * 3 + 0];
+      t->x = places[i * 3 + 1];
+      t->y = places[i * 3 + 2];
+    }
+    for(unsigned int i=0;i<count;i++) {
+      frame_renderer_atlas_upload(order[i]);
+    }
+  }
+
+  free(order);
+  free(places);
+  free(pages);
+  return fits;
+}
+
+FRAME_DEF bool frame_renderer_atlas_place(unsigned int texture) {
+  Frame_Renderer *r = &frame_renderer;
+  Frame_Renderer_Texture *t = &r->textures[texture];
+
+  int p = FRAME_RENDERER_ATLAS_PADDING;
+  int width = t->width + 2 * p;
+  int height = t->height + 2 * p;
+  int x, y;
+
+  for(int i=0;i<r->atlas_pages_count;i++) {
+    Frame_Renderer_Atlas_Page *page = &r->atlas_pages[i];
+    if(frame_renderer_skyline_insert(page->nodes, &page->nodes_count, width, height, &x, &y)) {
+      t->page = i;
+      t->x = x + p;
+      t->y = y + p;
+      return frame_renderer_atlas_upload(texture);
+    }
+  }
+
+  // enough was released, that moving the others likely makes room
+  size_t released = 0;
+  for(int i=0;i<r->atlas_pages_count;i++) {
+    released += r->atlas_pages[i].released_area;
+  }
+  if(released >= (size_t) width * height && frame_renderer_repack_atlas()) {
+    return true;
+  }
+
+  if(r->atlas_pages_count < FRAME_RENDERER_ATLAS_PAGES_CAP) {
+    unsigned int page_texture;
+    if(frame_renderer_push_texture_ex(FRAME_RENDERER_ATLAS_SIZE, FRAME_RENDERER_ATLAS_SIZE, NULL, false, 0, &page_texture)) {
+      Frame_Renderer_Atlas_Page *page = &r->atlas_pages[r->atlas_pages_count++];
+      page->texture = page_texture;
+      frame_renderer_atlas_page_clear(page);
+      
+      t = &r->textures[texture];
+      frame_renderer_skyline_insert(page->nodes, &page->nodes_count, width, height, &x, &y);
+      t->page = (int) (page - r->atlas_pages);
+      t->x = x + p;
+      t->y = y + p;
+      return frame_renderer_atlas_upload(texture);
+    }
+  }
+
+  // the new image takes part and gets uploaded as well
+  return frame_renderer_repack_atlas();
+}
+
+FRAME_DEF void frame_renderer_set_texture_flags(int flags) {
+  frame_renderer.texture_flags = flags;
+}
+
+FRAME_DEF void frame_renderer_set_max_resident_mip(int level) {
+  frame_renderer.max_resident_mip = level > 0 ? level : 0;
+}
+
+FRAME_DEF bool frame_renderer_create_texture(int width, int height, unsigned int *index) {
+  if(!frame_renderer_push_texture(width, height, NULL, false, index)) {
+    return false;
+  }
+
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_push_to_texture(unsigned int tex, const void *data, int x_off, int y_off, int width, int height) {
+  Frame_Renderer *r = &frame_renderer;
+  
+  if(tex >= r->textures_count || !r->textures[tex].used) return false;
+
+  Frame_Renderer_Texture *t = &r->textures[tex];
+  if(t->yuv) {
+    return false;
+  }
+  if(t->levels > 1 && (x_off != 0 || y_off != 0 || width != t->width || height != t->height)) {
+    FRAME_LOG("Mipmapped textures are only updated as a whole\n");
+    return false;
+  }
+  if(t->atlas) {
+    if(x_off < 0 || y_off < 0 || x_off + width > t->width || y_off + height > t->height) {
+      return false;
+    }
+    for(int y=0;y<height;y++) {
+      memcpy(t->pixels + ((size_t) (y_off + y) * t->width + x_off) * 4,
+	     (const unsigned char *) data + (size_t) y * width * 4,
+	     (size_t) width * 4);
+    }
+    return frame_renderer_atlas_upload(tex);
+  }
+  
+  if(!t->name && !frame_renderer_texture_restore(tex)) {
+    return false;
+  }
+  t = &r->textures[tex];
+
+  glActiveTexture(GL_TEXTURE0 + FRAME_RENDERER_UPLOAD_UNIT);
+  glBindTexture(GL_TEXTURE_2D, t->name);
+  FRAME_RENDERER_STAT(texture_binds, 1);
+  
+  GLenum format, type;
+  frame_renderer_texture_format(t->grey, &format, &type);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexSubImage2D(GL_TEXTURE_2D,
+		  0,
+		  x_off, y_off,
+		  width, height,
+		  format,
+		  type,
+		  data);
+  FRAME_RENDERER_STAT(bytes_uploaded, (size_t) width * height * (t->grey ? 1 : 4));
+
+  if(t->levels > 1) {
+    return frame_renderer_texture_upload_mips(t, (const unsigned char *) data);
+  }
+
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_create_stream(int width, int height, unsigned int *index) {
+  Frame_Renderer *r = &frame_renderer;
+
+  Frame_Renderer_Stream *stream = (Frame_Renderer_Stream *) calloc(1, sizeof(Frame_Renderer_Stream));
+  if(!stream) {
+    FRAME_LOG("Can not allocate enough memory\n");
+    return false;
+  }
+
+  // never packed or evicted, the buffers are copied straight into its name
+  if(!frame_renderer_push_texture_ex(width, height, NULL, false, 0, index)) {
+    free(stream);
+    return false;
+  }
+  Frame_Renderer_Texture *t = &r->textures[*index];
+  t->pinned = true;
+  t->stream = stream;
+
+  glGenBuffers(FRAME_RENDERER_STREAM_BUFFERS, stream->buffers);
+  for(int i=0;i<FRAME_RENDERER_STREAM_BUFFERS;i++) {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stream->buffers[i]);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr) t->bytes, NULL, GL_STREAM_DRAW);
+  }
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  return true;
+}
+
+FRAME_DEF Frame_Renderer_Stream *frame_renderer_stream_get(unsigned int tex) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(tex >= r->textures_count || !r->textures[tex].used) {
+    return NULL;
+  }
+  return r->textures[tex].stream;
+}
+
+FRAME_DEF bool frame_renderer_stream_map(unsigned int tex, void **pixels) {
+  Frame_Renderer_Stream *stream = frame_renderer_stream_get(tex);
+  if(!stream || stream->mapped) {
+    return false;
+  }
+  Frame_Renderer_Texture *t = &frame_renderer.textures[tex];
+
+  int i = stream->index;
+  if(stream->fences[i]) {
+    GLenum status = glClientWaitSync(stream->fences[i], 0, 0);
+    if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+      stream->dropped++;
+      return false;
+    }
+    glDeleteSync(stream->fences[i]);
+    stream->fences[i] = NULL;
+  }
+
+  // the fence says the gpu is done with it, so there is nothing to synchronize
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stream->buffers[i]);
+  *pixels = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr) t->bytes,
+			     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  if(!*pixels) {
+    FRAME_LOG("Can not map pixel buffer\n");
+    return false;
+  }
+
+  stream->mapped = true;
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_stream_commit(unsigned int tex) {
+  Frame_Renderer *r = &frame_renderer;
+
+  Frame_Renderer_Stream *stream = frame_renderer_stream_get(tex);
+  if(!stream || !stream->mapped) {
+    return false;
+  }
+  Frame_Renderer_Texture *t = &r->textures[tex];
+
+  int i = stream->index;
+  stream->index = (i + 1) % FRAME_RENDERER_STREAM_BUFFERS;
+  stream->mapped = false;
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stream->buffers[i]);
+  if(!glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+    // the content got lost, for example on a display mode change
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    stream->dropped++;
+    return false;
+  }
+
+  if(r->tex_index == (int) tex) {
+    // the batch still shows the previous frame
+    frame_renderer_flush(FRAME_RENDERER_FLUSH_TEXTURE);
+  }
+
+  glActiveTexture(GL_TEXTURE0 + FRAME_RENDERER_UPLOAD_UNIT);
+  glBindTexture(GL_TEXTURE_2D, t->name);
+  FRAME_RENDERER_STAT(texture_binds, 1);
+
+  // the offset into the bound buffer, the copy runs while the cpu goes on
+  GLenum format, type;
+  frame_renderer_texture_format(false, &format, &type);
+  glTexSubImage2D(GL_TEXTURE_2D,
+		  0,
+		  0, 0,
+		  t->width, t->height,
+		  format,
+		  type,
+		  (const void *) 0);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  FRAME_RENDERER_STAT(bytes_uploaded, t->bytes);
+
+  stream->fences[i] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  stream->commits++;
+
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_stream_counts(unsigned int tex, size_t *commits, size_t *dropped) {
+  Frame_Renderer_Stream *stream = frame_renderer_stream_get(tex);
+  if(!stream) {
+    return false;
+  }
+
+  *commits = stream->commits;
+  *dropped = stream->dropped;
+  return true;
+}
+
+FRAME_DEF void frame_renderer_stream_free(Frame_Renderer_Stream *stream) {
+  if(stream->mapped) {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stream->buffers[stream->index]);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  }
+  for(int i=0;i<FRAME_RENDERER_STREAM_BUFFERS;i++) {
+    if(stream->fences[i]) glDeleteSync(stream->fences[i]);
+  }
+  glDeleteBuffers(FRAME_RENDERER_STREAM_BUFFERS, stream->buffers);
+  free(stream);
+}
+
+FRAME_DEF bool frame_renderer_yuv_plane(GLuint *name, int width, int height, GLenum internal, GLenum format) {
+  glGenTextures(1, name);
+  if(!*name) {
+    FRAME_LOG("Can not create texture\n");
+    return false;
+  }
+  glBindTexture(GL_TEXTURE_2D, *name);
+  FRAME_RENDERER_STAT(texture_binds, 1);
+
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexImage2D(GL_TEXTURE_2D, 0, internal, width, height, 0, format, GL_UNSIGNED_BYTE, NULL);
+
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_create_yuv_texture(int width, int height, Frame_Renderer_Yuv_Format format, int flags, unsigned int *index) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(width <= 0 || height <= 0 ||
+     (format != FRAME_RENDERER_YUV_NV12 && format != FRAME_RENDERER_YUV_I420)) {
+    return false;
+  }
+  int chroma_width = (width + 1) / 2;
+  int chroma_height = (height + 1) / 2;
+  size_t bytes = (size_t) width * height + (size_t) chroma_width * chroma_height * 2;
+
+  unsigned int texture;
+  if(!frame_renderer_texture_alloc(&texture)) {
+    return false;
+  }
+  frame_renderer_texture_reserve(bytes);
+
+  // never evicted, there is no readback for several planes
+  Frame_Renderer_Texture *t = &r->textures[texture];
+  memset(t, 0, sizeof(*t));
+  t->width = width;
+  t->height = height;
+  t->bytes = bytes;
+  t->last_used = r->texture_tick;
+  t->used = true;
+  t->pinned = true;
+  t->levels = 1;
+  t->page = -1;
+  t->yuv = format;
+  t->yuv_flags = flags;
+
+  glActiveTexture(GL_TEXTURE0 + FRAME_RENDERER_UPLOAD_UNIT);
+  bool ok = frame_renderer_yuv_plane(&t->name, width, height, GL_R8, GL_RED);
+  if(format == FRAME_RENDERER_YUV_NV12) {
+    ok = ok && frame_renderer_yuv_plane(&t->planes[0], chroma_width, chroma_height, GL_RG8, GL_RG);
+  } else {
+    ok = ok && frame_renderer_yuv_plane(&t->planes[0], chroma_width, chroma_height, GL_R8, GL_RED);
+    ok = ok && frame_renderer_yuv_plane(&t->planes[1], chroma_width, chroma_height, GL_R8, GL_RED);
+  }
+  if(!ok) {
+    if(t->name) glDeleteTextures(1, &t->name);
+    if(t->planes[0]) glDeleteTextures(1, &t->planes[0]);
+    if(t->planes[1]) glDeleteTextures(1, &t->planes[1]);
+    memset(t, 0, sizeof(*t));
+    return false;
+  }
+
+  r->texture_memory.resident_bytes += t->bytes;
+  r->texture_memory.resident++;
+
+  *index = texture;
+  return true;
+}
+
+FRAME_DEF void frame_renderer_yuv_upload(GLuint name, int width, int height, GLenum format, int pixel_bytes, const void *data, int stride) {
+  glBindTexture(GL_TEXTURE_2D, name);
+  FRAME_RENDERER_STAT(texture_binds, 1);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, stride / pixel_bytes);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
+  FRAME_RENDERER_STAT(bytes_uploaded, (size_t) width * height * pixel_bytes);
+}
+
+FRAME_DEF bool frame_renderer_push_yuv(unsigned int tex, const void *y, int y_stride, const void *u, int u_stride, const void *v, int v_stride) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(tex >= r->textures_count || !r->textures[tex].used || !r->textures[tex].yuv) {
+    return false;
+  }
+  Frame_Renderer_Texture *t = &r->textures[tex];
+  if(!y || !u || (t->yuv == FRAME_RENDERER_YUV_I420 && !v)) {
+    return false;
+  }
+
+  if(r->tex_index == (int) tex) {
+    // the batch still shows the previous frame
+    frame_renderer_flush(FRAME_RENDERER_FLUSH_TEXTURE);
+  }
+
+  int chroma_width = (t->width + 1) / 2;
+  int chroma_height = (t->height + 1) / 2;
+
+  glActiveTexture(GL_TEXTURE0 + FRAME_RENDERER_UPLOAD_UNIT);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  frame_renderer_yuv_upload(t->name, t->width, t->height, GL_RED, 1, y, y_stride);
+  if(t->yuv == FRAME_RENDERER_YUV_NV12) {
+    frame_renderer_yuv_upload(t->planes[0], chroma_width, chroma_height, GL_RG, 2, u, u_stride);
+  } else {
+    frame_renderer_yuv_upload(t->planes[0], chroma_width, chroma_height, GL_RED, 1, u, u_stride);
+    frame_renderer_yuv_upload(t->planes[1], chroma_width, chroma_height, GL_RED, 1, v, v_stride);
+  }
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_push_texture(int width, int height, const void *data, bool grey, unsigned int *index) {
+  return frame_renderer_push_texture_ex(width, height, data, grey, frame_renderer.texture_flags, index);
+}
+
+FRAME_DEF bool frame_renderer_texture_init(unsigned int texture, int width, int height, const void *data, bool grey, int flags);
+
+FRAME_DEF bool frame_renderer_push_texture_ex(int width, int height, const void *data, bool grey, int flags, unsigned int *index) {
+
+  Frame_Renderer *r = &frame_renderer;
+
+  if(width <= 0 || height <= 0) {
+    return false;
+  }
+
+  unsigned int texture;
+  if(!frame_renderer_texture_alloc(&texture)) {
+    return false;
+  }
+
+  if(!frame_renderer_texture_init(texture, width, height, data, grey, flags)) {
+    r->textures[texture].used = false;
+    return false;
+  }
+  
+  *index = texture;
+
+  return true;
+}
+
+// fills the slot and uploads it, or places it on an atlas page
+FRAME_DEF bool frame_renderer_texture_init(unsigned int texture, int width, int height, const void *data, bool grey, int flags) {
+  Frame_Renderer *r = &frame_renderer;
+
+  bool mipmaps = (flags & FRAME_RENDERER_TEXTURE_MIPMAPS) != 0;
+  bool atlas = (flags & FRAME_RENDERER_TEXTURE_ATLAS) && !grey && !mipmaps &&
+    width <= FRAME_RENDERER_ATLAS_MAX_SIZE && height <= FRAME_RENDERER_ATLAS_MAX_SIZE;
+
+  int channels = grey ? 1 : 4;
+  int levels = 1;
+  unsigned char *reduced = NULL;
+  if(mipmaps) {
+    levels = frame_renderer_mip_levels(width, height);
+    
+    int drop = r->max_resident_mip < levels ? r->max_resident_mip : levels - 1;
+    if(drop > 0 && data) {
+      reduced = frame_renderer_mip_reduce((const unsigned char *) data, width, height, channels, drop);
+      if(!reduced) {
+	FRAME_LOG("Can not allocate enough memory\n");
+	return false;
+      }
+      data = reduced;
+    }
+    if(drop > 0) {
+      width = frame_renderer_mip_size(width, drop);
+      height = frame_renderer_mip_size(height, drop);
+      levels -= drop;
+    }
+  }
+
+  Frame_Renderer_Texture *t = &r->textures[texture];
+  memset(t, 0, sizeof(*t));
+  t->width = width;
+  t->height = height;
+  t->grey = grey;
+  t->levels = levels;
+  t->bytes = frame_renderer_mip_bytes(width, height, channels, levels);
+  t->last_used = r->texture_tick;
+  t->used = true;
+  t->page = -1;
+
+  if(atlas) {
+    t->pixels = (unsigned char *) calloc(t->bytes, 1);
+    if(t->pixels) {
+      if(data) memcpy(t->pixels, data, t->bytes);
+      t->atlas = true;
+      if(frame_renderer_atlas_place(texture)) {
+	return true;
+      }
+
+      // no room, even after repacking
+      t = &r->textures[texture];
+      free(t->pixels);
+      t->pixels = NULL;
+      t->atlas = false;
+      t->page = -1;
+    }
+  }
+  
+  bool result = frame_renderer_texture_upload(texture, data);
+  free(reduced);
+  
+  return result;
+}
+
+FRAME_DEF void frame_renderer_release_texture(unsigned int texture) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(texture >= r->textures_count || !r->textures[texture].used) {
+    return;
+  }
+  Frame_Renderer_Texture *t = &r->textures[texture];
+  Frame_Renderer_Texture_Memory *m = &r->texture_memory;
+
+  if(r->tex_index == (int) texture) {
+    // the batch may still sample it
+    frame_renderer_flush(FRAME_RENDERER_FLUSH_TEXTURE);
+    r->tex_index = -1;
+  }
+  if(r->font_index == (int) texture) {
+    r->font_index = -1;
+  }
+
+  if(t->stream) {
+    frame_renderer_stream_free(t->stream);
+  }
+  if(t->yuv) {
+    glDeleteTextures(t->yuv == FRAME_RENDERER_YUV_I420 ? 2 : 1, t->planes);
+  }
+  
+  if(t->loading) {
+    // the job is freed when it comes back
+    t->work->cancelled = true;
+  } else if(t->failed) {
+  } else if(t->atlas) {
+    if(t->page >= 0) {
+      int p = FRAME_RENDERER_ATLAS_PADDING;
+      r->atlas_pages[t->page].released_area += (size_t) (t->width + 2 * p) * (t->height + 2 * p);
+    }
+    free(t->pixels);
+  } else if(t->name) {
+    glDeleteTextures(1, &t->name);
+    m->resident_bytes -= t->bytes;
+    m->resident--;
+  } else {
+    free(t->pixels);
+    m->evicted_bytes -= t->bytes;
+    m->evicted--;
+  }
+  memset(t, 0, sizeof(*t));
+}
+
+FRAME_DEF Frame_Renderer_Texture_State frame_renderer_texture_state(unsigned int texture) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(texture >= r->textures_count || !r->textures[texture].used) {
+    return FRAME_RENDERER_TEXTURE_INVALID;
+  }
+  Frame_Renderer_Texture *t = &r->textures[texture];
+  if(t->loading) {
+    return FRAME_RENDERER_TEXTURE_LOADING;
+  }
+  if(t->failed) {
+    return FRAME_RENDERER_TEXTURE_FAILED;
+  }
+  return FRAME_RENDERER_TEXTURE_READY;
+}
+
+FRAME_DEF bool frame_renderer_texture_size(unsigned int texture, int *width, int *height) {
+  if(frame_renderer_texture_state(texture) != FRAME_RENDERER_TEXTURE_READY) {
+    return false;
+  }
+  *width = frame_renderer.textures[texture].width;
+  *height = frame_renderer.textures[texture].height;
+  return true;
+}
+
+FRAME_DEF void frame_renderer_set_texture_budget(size_t bytes) {
+  frame_renderer.texture_memory.budget = bytes;
+  frame_renderer_texture_reserve(0);
+}
+
+FRAME_DEF void frame_renderer_texture_memory(Frame_Renderer_Texture_Memory *memory) {
+  *memory = frame_renderer.texture_memory;
+}
+
+FRAME_DEF bool frame_renderer_texture_bytes(unsigned int texture, size_t *bytes, bool *resident) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(texture >= r->textures_count || !r->textures[texture].used) {
+    return false;
+  }
+  Frame_Renderer_Texture *t = &r->textures[texture];
+  *bytes = t->bytes;
+  *resident = t->name != 0;
+  if(t->atlas) {
+    *resident = t->page >= 0 && r->textures[r->atlas_pages[t->page].texture].name != 0;
+  }
+  return true;
+}
+
+FRAME_DEF void frame_renderer_file_unmap(Frame_Renderer_File_Map *map) {
+  if(map->view) UnmapViewOfFile(map->view);
+  if(map->mapping) CloseHandle(map->mapping);
+  if(map->file && map->file != INVALID_HANDLE_VALUE) CloseHandle(map->file);
+  memset(map, 0, sizeof(*map));
+}
+
+FRAME_DEF bool frame_renderer_file_map(const char *filepath, Frame_Renderer_File_Map *map) {
+  memset(map, 0, sizeof(*map));
+
+  // others may still rename, delete or touch the file while it is mapped
+  map->file = CreateFile(filepath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+			 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if(map->file == INVALID_HANDLE_VALUE) {
+    map->file = NULL;
+    return false;
+  }
+
+  DWORD size = GetFileSize(map->file, NULL);
+  if(size == INVALID_FILE_SIZE || size == 0) {
+    frame_renderer_file_unmap(map);
+    return false;
+  }
+  map->size = (size_t) size;
+
+  map->mapping = CreateFileMapping(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if(map->mapping) {
+    map->view = (const unsigned char *) MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0);
+  }
+  if(!map->view) {
+    frame_renderer_file_unmap(map);
+    return false;
+  }
+
+  return true;
+}
+
+// Size and time of 'filepath', the hash is left to frame_renderer_file_hash
+FRAME_DEF bool frame_renderer_file_stamp(const char *filepath, Frame_Renderer_File_Stamp *stamp) {
+  WIN32_FILE_ATTRIBUTE_DATA attributes;
+  if(!GetFileAttributesEx(filepath, GetFileExInfoStandard, &attributes)) {
+    FRAME_LOG("Can not open file: %s\n", filepath);
+    return false;
+  }
+
+  stamp->size = ((unsigned long long) attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+  stamp->time = ((unsigned long long) attributes.ftLastWriteTime.dwHighDateTime << 32) |
+    attributes.ftLastWriteTime.dwLowDateTime;
+  stamp->hash = 0;
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_file_hash(const char *filepath, unsigned long long *hash) {
+  Frame_Renderer_File_Map map;
+  if(!frame_renderer_file_map(filepath, &map)) {
+    FRAME_LOG("Can not open file: %s\n", filepath);
+    return false;
+  }
+  *hash = frame_renderer_hash(FRAME_RENDERER_HASH_INIT, map.view, map.size);
+  frame_renderer_file_unmap(&map);
+  return true;
+}
+
+// Whether 'filepath', now at 'current', still holds what 'stamp' was taken of. Only a file
+// of the same size with a new time is hashed, it may have been touched but not changed.
+FRAME_DEF bool frame_renderer_file_unchanged(const char *filepath, const Frame_Renderer_File_Stamp *stamp, const Frame_Renderer_File_Stamp *current) {
+  if(stamp->size != current->size) {
+    return false;
+  }
+  if(stamp->time == current->time) {
+    return true;
+  }
+
+  unsigned long long hash;
+  return frame_renderer_file_hash(filepath, &hash) && hash == stamp->hash;
+}
+
+// Writes 'header' and then 'body' to a file of its own and moves that over 'filepath',
+// so a reader never sees half of it
+FRAME_DEF bool frame_renderer_file_replace(const char *filepath, const void *header, size_t header_size, const void *body, size_t body_size) {
+  char temp_path[MAX_PATH];
+  snprintf(temp_path, sizeof(temp_path), "%s.%lu.tmp", filepath, (unsigned long) GetCurrentThreadId());
+
+  HANDLE handle = CreateFile(temp_path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if(handle == INVALID_HANDLE_VALUE) {
+    FRAME_LOG("Can not create file: %s\n", temp_path);
+    return false;
+  }
+
+  DWORD n, m;
+  bool ok = WriteFile(handle, header, (DWORD) header_size, &n, NULL) && n == (DWORD) header_size &&
+    (body_size == 0 || (WriteFile(handle, body, (DWORD) body_size, &m, NULL) && m == (DWORD) body_size));
+  CloseHandle(handle);
+
+  if(!ok || !MoveFileEx(temp_path, filepath, MOVEFILE_REPLACE_EXISTING)) {
+    FRAME_LOG("Can not write file: %s\n", filepath);
+    DeleteFile(temp_path);
+    return false;
+  }
+  return true;
+}
+
+FRAME_DEF void frame_renderer_pack_close(Frame_Renderer_Pack *pack) {
+  if(pack->view) UnmapViewOfFile(pack->view);
+  if(pack->mapping) CloseHandle(pack->mapping);
+  if(pack->file && pack->file != INVALID_HANDLE_VALUE) CloseHandle(pack->file);
+  memset(pack, 0, sizeof(*pack));
+}
+
+FRAME_DEF bool frame_renderer_pack_open(const char *filepath, Frame_Renderer_Pack *pack) {
+  memset(pack, 0, sizeof(*pack));
+
+  pack->file = CreateFile(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if(pack->file == INVALID_HANDLE_VALUE) {
+    FRAME_LOG("Can not open file: %s\n", filepath);
+    pack->file = NULL;
+    return false;
+  }
+
+  DWORD size = GetFileSize(pack->file, NULL);
+  if(size == INVALID_FILE_SIZE || size < sizeof(Frame_Renderer_Pack_Header)) {
+    FRAME_LOG("Not an asset pack: %s\n", filepath);
+    frame_renderer_pack_close(pack);
+    return false;
+  }
+  pack->size = (size_t) size;
+
+  pack->mapping = CreateFileMapping(pack->file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if(pack->mapping) {
+    pack->view = (const unsigned char *) MapViewOfFile(pack->mapping, FILE_MAP_READ, 0, 0, 0);
+  }
+  if(!pack->view) {
+    FRAME_LOG("Can not map file: %s\n", filepath);
+    frame_renderer_pack_close(pack);
+    return false;
+  }
+
+  const Frame_Renderer_Pack_Header *header = (const Frame_Renderer_Pack_Header *) pack->view;
+  if(header->magic != FRAME_RENDERER_PACK_MAGIC || header->version != FRAME_RENDERER_PACK_VERSION ||
+     sizeof(*header) + (size_t) header->entries_count * sizeof(Frame_Renderer_Pack_Entry) > pack->size) {
+    FRAME_LOG("Not an asset pack: %s\n", filepath);
+    frame_renderer_pack_close(pack);
+    return false;
+  }
+  pack->entries = (const Frame_Renderer_Pack_Entry *) (pack->view + sizeof(*header));
+  pack->entries_count = header->entries_count;
+
+  // checked once, so lookups can trust the entries
+  for(unsigned int i=0;i<pack->entries_count;i++) {
+    const Frame_Renderer_Pack_Entry *e = &pack->entries[i];
+    bool ok = memchr(e->name, 0, sizeof(e->name)) != NULL &&
+      e->offset <= pack->size && e->size <= pack->size - e->offset;
+    if(e->kind == FRAME_RENDERER_PACK_TEXTURE) {
+      ok = ok && e->width > 0 && e->height > 0 && e->size == (unsigned long long) e->width * e->height * 4;
+    } else if(e->kind == FRAME_RENDERER_PACK_FONT) {
+      ok = ok && e->width > 0 && e->height > 0 &&
+	e->size == FRAME_RENDERER_PACK_FONT_CHARS_SIZE + (unsigned long long) e->width * e->height;
+    }
+    if(!ok) {
+      FRAME_LOG("Corrupt asset pack entry %u: %s\n", i, filepath);
+      frame_renderer_pack_close(pack);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// baked fonts are found by their pixel height, other kinds ignore it
+FRAME_DEF const Frame_Renderer_Pack_Entry *frame_renderer_pack_find(const Frame_Renderer_Pack *pack, const char *name, Frame_Renderer_Pack_Kind kind, float pixel_height) {
+  for(unsigned int i=0;i<pack->entries_count;i++) {
+    const Frame_Renderer_Pack_Entry *e = &pack->entries[i];
+    if(e->kind != (unsigned int) kind || strcmp(e->name, name) != 0) continue;
+    if(kind == FRAME_RENDERER_PACK_FONT && e->pixel_height != pixel_height) continue;
+    return e;
+  }
+  return NULL;
+}
+
+FRAME_DEF const void *frame_renderer_pack_data(const Frame_Renderer_Pack *pack, const Frame_Renderer_Pack_Entry *entry) {
+  return pack->view + entry->offset;
+}
+
+FRAME_DEF bool frame_renderer_push_image_from_pack(const Frame_Renderer_Pack *pack, const char *name, int *width, int *height, unsigned int *index) {
+
+  const Frame_Renderer_Pack_Entry *e = frame_renderer_pack_find(pack, name, FRAME_RENDERER_PACK_TEXTURE, 0);
+  if(e) {
+    *width = e->width;
+    *height = e->height;
+    return frame_renderer_push_texture(e->width, e->height, frame_renderer_pack_data(pack, e), false, index);
+  }
+
+#ifdef FRAME_STB_IMAGE
+  e = frame_renderer_pack_find(pack, name, FRAME_RENDERER_PACK_FILE, 0);
+  if(e) {
+    return frame_renderer_push_image_memory((unsigned char *) frame_renderer_pack_data(pack, e), (size_t) e->size,
+					    width, height, index);
+  }
+#endif //FRAME_STB_IMAGE
+
+  FRAME_LOG("Asset pack has no image: %s\n", name);
+  return false;
+}
+
+#define FRAME_RENDERER_TARGET_GRANULARITY 64
+
+FRAME_DEF void frame_renderer_blend() {
+  if(frame_renderer.target_active >= 0) {
+    // keep the target premultiplied, so it composites like it was drawn directly
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+  } else {
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  }
+}
+
+FRAME_DEF bool frame_renderer_target_storage(Frame_Renderer_Target *t, int width, int height) {
+  Frame_Renderer *r = &frame_renderer;
+  
+  glActiveTexture(GL_TEXTURE0 + FRAME_RENDERER_UPLOAD_UNIT);
+  glBindTexture(GL_TEXTURE_2D, t->texture);
+  FRAME_RENDERER_STAT(texture_binds, 1);
+  glTexImage2D(GL_TEXTURE_2D,
+	       0,
+	       GL_RGBA,
+	       width,
+	       height,
+	       0,
+	       GL_RGBA,
+	       GL_UNSIGNED_INT_8_8_8_8_REV,
+	       NULL);
+
+  glBindRenderbuffer(GL_RENDERBUFFER, t->rbo);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, t->fbo);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, t->texture, 0);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, t->rbo);
+  GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+  GLuint active = 0;
+  if(r->target_active >= 0) {
+    active = r->targets[r->target_active].fbo;
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, active);
+  
+  if(status != GL_FRAMEBUFFER_COMPLETE) {
+    FRAME_LOG("Render target is incomplete: 0x%x\n", status);
+    return false;
+  }
+
+  // keep the accounting of the registry in sync
+  Frame_Renderer_Texture *texture = &r->textures[t->index];
+  size_t bytes = (size_t) width * height * 4;
+  r->texture_memory.resident_bytes += bytes - texture->bytes;
+  texture->bytes = bytes;
+  texture->width = width;
+  texture->height = height;
+
+  t->width = width;
+  t->height = height;
+  
+  return true;
+}
+
+FRAME_DEF int frame_renderer_target_round(int n) {
+  return (n + FRAME_RENDERER_TARGET_GRANULARITY - 1) / FRAME_RENDERER_TARGET_GRANULARITY * FRAME_RENDERER_TARGET_GRANULARITY;
+}
+
+FRAME_DEF bool frame_renderer_target_create(int width, int height, unsigned int *target) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(width <= 0 || height <= 0) {
+    return false;
+  }
+
+  // prefer the smallest pooled target that fits
+  Frame_Renderer_Target *best = NULL;
+  Frame_Renderer_Target *smaller = NULL;
+  Frame_Renderer_Target *empty = NULL;
+  for(int i=0;i<FRAME_RENDERER_TARGETS_CAP;i++) {
+    Frame_Renderer_Target *t = &r->targets[i];
+    if(!t->created) {
+      if(!empty) empty = t;
+      continue;
+    }
+    if(t->in_use) continue;
+
+    if(t->width >= width && t->height >= height) {
+      if(!best || t->width * t->height < best->width * best->height) best = t;
+    } else if(!smaller) {
+      smaller = t;
+    }
+  }
+
+  Frame_Renderer_Target *t = best;
+  if(!t && empty) {
+    unsigned int index;
+    if(!frame_renderer_push_texture_ex(1, 1, NULL, false, 0, &index)) {
+      FRAME_LOG("No texture left for a render target\n");
+      return false;
+    }
+    
+    t = empty;
+    t->index = index;
+    t->texture = r->textures[index].name;
+    r->textures[index].pinned = true;
+    glGenFramebuffers(1, &t->fbo);
+    glGenRenderbuffers(1, &t->rbo);
+    t->width = 0;
+    t->height = 0;
+    t->created = true;
+  }
+  if(!t) {
+    t = smaller;
+  }
+  if(!t) {
+    return false;
+  }
+
+  if(t->width < width || t->height < height) {
+    int w = frame_renderer_target_round(width);
+    int h = frame_renderer_target_round(height);
+    if(!frame_renderer_target_storage(t,
+				      w > t->width ? w : t->width,
+				      h > t->height ? h : t->height)) {
+      return false;
+    }
+  }
+
+  t->used_width = width;
+  t->used_height = height;
+  t->in_use = true;
+  *target = (unsigned int) (t - r->targets);
+  
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_target_resize(unsigned int target, int width, int height) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(target >= FRAME_RENDERER_TARGETS_CAP || width <= 0 || height <= 0) {
+    return false;
+  }
+  Frame_Renderer_Target *t = &r->targets[target];
+  if(!t->in_use) {
+    return false;
+  }
+
+  bool active = r->target_active == (int) target;
+  if(active) {
+    frame_renderer_flush(FRAME_RENDERER_FLUSH_STATE);
+  }
+
+  if(t->width < width || t->height < height) {
+    int w = frame_renderer_target_round(width);
+    int h = frame_renderer_target_round(height);
+    if(!frame_renderer_target_storage(t,
+				      w > t->width ? w : t->width,
+				      h > t->height ? h : t->height)) {
+      return false;
+    }
+  }
+  t->used_width = width;
+  t->used_height = height;
+
+  if(active) {
+    glViewport(0, 0, width, height);
+    frame_renderer_resolution((float) width, (float) height);
+  }
+
+  return true;
+}
+
+FRAME_DEF void frame_renderer_target_release(unsigned int target) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(target >= FRAME_RENDERER_TARGETS_CAP) {
+    return;
+  }
+  if(r->target_active == (int) target) {
+    frame_renderer_target_end();
+  }
+  r->targets[target].in_use = false;
+}
+
+FRAME_DEF bool frame_renderer_target_begin(unsigned int target) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(target >= FRAME_RENDERER_TARGETS_CAP || !r->targets[target].in_use) {
+    return false;
+  }
+  if(r->target_active >= 0) {
+    frame_renderer_target_end();
+  }
+  Frame_Renderer_Target *t = &r->targets[target];
+
+  // what is queued so far belongs to the window
+  frame_renderer_flush(FRAME_RENDERER_FLUSH_STATE);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, t->fbo);
+  glViewport(0, 0, t->used_width, t->used_height);
+  frame_renderer_resolution((float) t->used_width, (float) t->used_height);
+  
+  glClearColor(0, 0, 0, 0);
+  glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+  Frame_Renderer_Vec4f *c = &r->background;
+  glClearColor(c->x, c->y, c->z, c->w);
+
+  r->target_active = (int) target;
+  frame_renderer_blend();
+
+  return true;
+}
+
+FRAME_DEF void frame_renderer_target_end() {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(r->target_active < 0) {
+    return;
+  }
+  frame_renderer_flush(FRAME_RENDERER_FLUSH_STATE);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glViewport(0, 0, (GLsizei) r->width, (GLsizei) r->height);
+  frame_renderer_resolution(r->width, r->height);
+  
+  r->target_active = -1;
+  frame_renderer_blend();
+}
+
+FRAME_DEF unsigned int frame_renderer_target_texture(unsigned int target) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(target >= FRAME_RENDERER_TARGETS_CAP) {
+    return 0;
+  }
+  return r->targets[target].index;
+}
+
+FRAME_DEF void frame_renderer_target_draw(unsigned int target, Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s, Frame_Renderer_Vec4f c) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(target >= FRAME_RENDERER_TARGETS_CAP || !r->targets[target].in_use) {
+    return;
+  }
+  Frame_Renderer_Target *t = &r->targets[target];
+
+  frame_renderer_flush(FRAME_RENDERER_FLUSH_STATE);
+  glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+  // framebuffer rows are bottom up, while the shader flips v
+  float u = (float) t->used_width / (float) t->width;
+  float v = (float) t->used_height / (float) t->height;
+  frame_renderer_texture_colored(t->index, p, s,
+				 vec2f(0, 1), vec2f(u, -v),
+				 vec4f(c.x * c.w, c.y * c.w, c.z * c.w, c.w));
+  
+  frame_renderer_flush(FRAME_RENDERER_FLUSH_STATE);
+  frame_renderer_blend();
+}
+
+#ifdef FRAME_STB_TRUETYPE
+#include <stdio.h>
+
+FRAME_DEF void frame_renderer_font_use(unsigned int texture) {
+  Frame_Renderer *r = &frame_renderer;
+
+  frame_renderer_flush(FRAME_RENDERER_FLUSH_TEXTURE);
+  r->textures[texture].pinned = true;
+  r->font_index = (int) texture;
+
+  glActiveTexture(GL_TEXTURE0 + FRAME_RENDERER_FONT_UNIT);
+  glBindTexture(GL_TEXTURE_2D, r->textures[texture].name);
+  FRAME_RENDERER_STAT(texture_binds, 1);
+}
+
+FRAME_DEF void frame_renderer_glyph_cache_reset() {
+  Frame_Renderer *r = &frame_renderer;
+
+  for(int i=0;i<FRAME_RENDERER_GLYPHS_CAP;i++) {
+    r->glyph_buckets[i] = -1;
+    r->glyphs[i].next = i + 1 < FRAME_RENDERER_GLYPHS_CAP ? i + 1 : -1;
+  }
+  r->glyphs_free = 0;
+  r->glyphs_empty = -1;
+  r->glyph_shelves_count = 0;
+  r->glyph_bottom = 0;
+}
+
+FRAME_DEF unsigned int frame_renderer_glyph_hash(int font, int codepoint, float size) {
+  unsigned int s;
+  memcpy(&s, &size, sizeof(s));
+  unsigned int h = (unsigned int) font * 0x9e3779b1u;
+  h = (h ^ (unsigned int) codepoint) * 0x85ebca6bu;
+  h = (h ^ s) * 0xc2b2ae35u;
+  return (h ^ (h >> 16)) & (FRAME_RENDERER_GLYPHS_CAP - 1);
+}
+
+FRAME_DEF void frame_renderer_glyph_unlink(int index) {
+  Frame_Renderer *r = &frame_renderer;
+  Frame_Renderer_Glyph *g = &r->glyphs[index];
+
+  int *link = &r->glyph_buckets[frame_renderer_glyph_hash(g->font, g->codepoint, g->size)];
+  while(*link != index) {
+    link = &r->glyphs[*link].next;
+  }
+  *link = g->next;
+
+  g->next = r->glyphs_free;
+  r->glyphs_free = index;
+}
+
+FRAME_DEF void frame_renderer_glyph_shelf_clear(int shelf) {
+  Frame_Renderer *r = &frame_renderer;
+  Frame_Renderer_Glyph_Shelf *s = &r->glyph_shelves[shelf];
+
+  // the batch may still sample it
+  if(s->last_used >= r->texture_tick) {
+    frame_renderer_flush(FRAME_RENDERER_FLUSH_TEXTURE);
+  }
+
+  for(int i=s->glyphs;i>=0;) {
+    int next = r->glyphs[i].shelf_next;
+    frame_renderer_glyph_unlink(i);
+    i = next;
+  }
+  s->glyphs = -1;
+  s->x = 0;
+  s->pinned = 0;
+  s->generation = ++r->glyph_generation;
+}
+
+// Frees the glyphs without pixels of 'font', or for 0 the ones that can be rasterized again
+FRAME_DEF void frame_renderer_glyph_empty_clear(int font) {
+  Frame_Renderer *r = &frame_renderer;
+
+  int *link = &r->glyphs_empty;
+  while(*link >= 0) {
+    int index = *link;
+    Frame_Renderer_Glyph *g = &r->glyphs[index];
+    bool drop = g->font == font;
+    if(font == 0) {
+      // glyphs of released fonts are dropped too
+      drop = true;
+      for(int i=0;i<FRAME_RENDERER_FONTS_CAP;i++) {
+	if(r->fonts[i].used && r->fonts[i].id == g->font && !r->fonts[i].rasterize) drop = false;
+      }
+    }
+    if(drop) {
+      *link = g->shelf_next;
+      frame_renderer_glyph_unlink(index);
+    } else {
+      link = &g->shelf_next;
+    }
+  }
+}
+
+// Drops every shelf that is not pinned, when no single shelf can be reused
+FRAME_DEF void frame_renderer_glyph_cache_compact() {
+  Frame_Renderer *r = &frame_renderer;
+
+  int count = 0;
+  r->glyph_bottom = 0;
+  for(int i=0;i<r->glyph_shelves_count;i++) {
+    Frame_Renderer_Glyph_Shelf *s = &r->glyph_shelves[i];
+    if(!s->pinned) {
+      frame_renderer_glyph_shelf_clear(i);
+      continue;
+    }
+    for(int j=s->glyphs;j>=0;j=r->glyphs[j].shelf_next) {
+      r->glyphs[j].shelf = count;
+    }
+    if(s->y + s->height > r->glyph_bottom) r->glyph_bottom = s->y + s->height;
+    r->glyph_shelves[count++] = *s;
+  }
+  r->glyph_shelves_count = count;
+}
+
+FRAME_DEF int frame_renderer_glyph_shelf_place(int width, int height) {
+  Frame_Renderer *r = &frame_renderer;
+
+  int size = FRAME_RENDERER_GLYPH_ATLAS_SIZE;
+  if(width > size || height > size) {
+    return -1;
+  }
+
+  // the lowest shelf with room
+  int best = -1;
+  for(int i=0;i<r->glyph_shelves_count;i++) {
+    Frame_Renderer_Glyph_Shelf *s = &r->glyph_shelves[i];
+    if(s->height < height || s->x + width > size) continue;
+    if(best < 0 || s->height < r->glyph_shelves[best].height) best = i;
+  }
+  // do not waste a tall shelf on a small glyph while there is space
+  int rounded = (height + FRAME_RENDERER_GLYPH_SHELF_ROUNDING - 1) / FRAME_RENDERER_GLYPH_SHELF_ROUNDING * FRAME_RENDERER_GLYPH_SHELF_ROUNDING;
+  bool space = r->glyph_bottom + rounded <= size && r->glyph_shelves_count < FRAME_RENDERER_GLYPH_SHELVES_CAP;
+  if(best >= 0 && (!space || r->glyph_shelves[best].height <= rounded + rounded / 2)) {
+    return best;
+  }
+
+  if(space) {
+    Frame_Renderer_Glyph_Shelf *s = &r->glyph_shelves[r->glyph_shelves_count];
+    s->y = r->glyph_bottom;
+    s->height = rounded;
+    s->x = 0;
+    s->glyphs = -1;
+    s->last_used = r->texture_tick;
+    s->pinned = 0;
+    s->generation = ++r->glyph_generation;
+    r->glyph_bottom += rounded;
+    return r->glyph_shelves_count++;
+  }
+
+  int lru = -1;
+  for(int i=0;i<r->glyph_shelves_count;i++) {
+    Frame_Renderer_Glyph_Shelf *s = &r->glyph_shelves[i];
+    if(s->pinned || s->height < height) continue;
+    if(lru < 0 || s->last_used < r->glyph_shelves[lru].last_used) lru = i;
+  }
+  if(lru >= 0) {
+    frame_renderer_glyph_shelf_clear(lru);
+    return lru;
+  }
+
+  frame_renderer_glyph_cache_compact();
+  if(r->glyph_bottom + rounded > size) {
+    return -1;
+  }
+  return frame_renderer_glyph_shelf_place(width, height);
+}
+
+// A glyph with room for width x height pixels, or NULL when they do not fit
+FRAME_DEF Frame_Renderer_Glyph *frame_renderer_glyph_alloc(int font, int codepoint, float size, int width, int height) {
+  Frame_Renderer *r = &frame_renderer;
+
+  int p = FRAME_RENDERER_GLYPH_PADDING;
+  int shelf = -1;
+  if(width > 0 && height > 0) {
+    shelf = frame_renderer_glyph_shelf_place(width + 2 * p, height + 2 * p);
+    if(shelf < 0) {
+      return NULL;
+    }
+  }
+
+  if(r->glyphs_free < 0) {
+    // every glyph is in use, make room
+    int lru = -1;
+    for(int i=0;i<r->glyph_shelves_count;i++) {
+      Frame_Renderer_Glyph_Shelf *s = &r->glyph_shelves[i];
+      if(s->pinned || i == shelf || s->glyphs < 0) continue;
+      if(lru < 0 || s->last_used < r->glyph_shelves[lru].last_used) lru = i;
+    }
+    if(r->glyphs_empty >= 0 && (lru < 0 || r->glyphs_empty_used < r->glyph_shelves[lru].last_used)) {
+      frame_renderer_glyph_empty_clear(0);
+    }
+    if(r->glyphs_free < 0 && lru >= 0) {
+      frame_renderer_glyph_shelf_clear(lru);
+    }
+    if(r->glyphs_free < 0) {
+      return NULL;
+    }
+  }
+
+  int index = r->glyphs_free;
+  Frame_Renderer_Glyph *g = &r->glyphs[index];
+  r->glyphs_free = g->next;
+
+  unsigned int hash = frame_renderer_glyph_hash(font, codepoint, size);
+  g->next = r->glyph_buckets[hash];
+  r->glyph_buckets[hash] = index;
+
+  g->font = font;
+  g->codepoint = codepoint;
+  g->size = size;
+  g->shelf = shelf;
+  g->shelf_next = -1;
+  g->x0 = g->y0 = g->x1 = g->y1 = 0;
+  if(shelf >= 0) {
+    Frame_Renderer_Glyph_Shelf *s = &r->glyph_shelves[shelf];
+    g->x0 = (short) (s->x + p);
+    g->y0 = (short) (s->y + p);
+    g->x1 = (short) (g->x0 + width);
+    g->y1 = (short) (g->y0 + height);
+    g->shelf_next = s->glyphs;
+    s->glyphs = index;
+    s->x += width + 2 * p;
+    s->last_used = r->texture_tick;
+  } else {
+    g->shelf_next = r->glyphs_empty;
+    r->glyphs_empty = index;
+    r->glyphs_empty_used = r->texture_tick;
+  }
+
+  return g;
+}
+
+// 'stride' is the row length of 'pixels' in bytes
+FRAME_DEF void frame_renderer_glyph_atlas_upload(int x, int y, int width, int height, const unsigned char *pixels, int stride) {
+  Frame_Renderer *r = &frame_renderer;
+
+  glActiveTexture(GL_TEXTURE0 + FRAME_RENDERER_UPLOAD_UNIT);
+  glBindTexture(GL_TEXTURE_2D, r->textures[r->font_index].name);
+  FRAME_RENDERER_STAT(texture_binds, 1);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  if(stride != width) glPixelStorei(GL_UNPACK_ROW_LENGTH, stride);
+
+  GLenum format, type;
+  frame_renderer_texture_format(true, &format, &type);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format, type, pixels);
+  FRAME_RENDERER_STAT(bytes_uploaded, (size_t) width * height);
+
+  if(stride != width) glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+// 'pixels' are the padded glyph
+FRAME_DEF void frame_renderer_glyph_upload(Frame_Renderer_Glyph *g, const unsigned char *pixels) {
+  int p = FRAME_RENDERER_GLYPH_PADDING;
+  int width = g->x1 - g->x0 + 2 * p;
+  frame_renderer_glyph_atlas_upload(g->x0 - p, g->y0 - p, width, g->y1 - g->y0 + 2 * p, pixels, width);
+}
+
+FRAME_DEF Frame_Renderer_Glyph *frame_renderer_glyph_find(const Frame_Renderer_Font *f, int codepoint) {
+  Frame_Renderer *r = &frame_renderer;
+
+  for(int i=r->glyph_buckets[frame_renderer_glyph_hash(f->id, codepoint, f->size)];i>=0;i=r->glyphs[i].next) {
+    Frame_Renderer_Glyph *g = &r->glyphs[i];
+    if(g->font == f->id && g->codepoint == codepoint && g->size == f->size) {
+      if(g->shelf >= 0) {
+	r->glyph_shelves[g->shelf].last_used = r->texture_tick;
+      } else {
+	r->glyphs_empty_used = r->texture_tick;
+      }
+      return g;
+    }
+  }
+  return NULL;
+}
+
+// Touches no state of the renderer, the workers run it
+FRAME_DEF void frame_renderer_glyph_rasterize(const Frame_Renderer_Font *f, Frame_Renderer_Glyph_Bitmap *b) {
+
+  // as stbtt_BakeFontBitmap
+  int glyph = stbtt_FindGlyphIndex(&f->info, b->codepoint);
+  int advance, lsb, x0, y0, width, height;
+  stbtt_GetGlyphHMetrics(&f->info, glyph, &advance, &lsb);
+
+  unsigned char *sdf = NULL;
+  if(f->sdf) {
+    sdf = stbtt_GetGlyphSDF(&f->info, f->scale, glyph, FRAME_RENDERER_SDF_PADDING, 128,
+			    128.0f / (float) FRAME_RENDERER_SDF_PADDING, &width, &height, &x0, &y0);
+    if(!sdf) {
+      width = height = x0 = y0 = 0; // nothing to draw
+    }
+  } else {
+    int x1, y1;
+    stbtt_GetGlyphBitmapBox(&f->info, glyph, f->scale, f->scale, &x0, &y0, &x1, &y1);
+    width = x1 - x0;
+    height = y1 - y0;
+  }
+
+  b->x0 = x0;
+  b->y0 = y0;
+  b->width = width;
+  b->height = height;
+  b->xadvance = f->scale * (float) advance;
+  b->pixels = NULL;
+
+  if(width > 0 && height > 0) {
+    int p = FRAME_RENDERER_GLYPH_PADDING;
+    int stride = width + 2 * p;
+    b->pixels = (unsigned char *) calloc((size_t) stride * (height + 2 * p), 1);
+    if(b->pixels) {
+      if(sdf) {
+	for(int y=0;y<height;y++) {
+	  memcpy(b->pixels + (size_t) (y + p) * stride + p, sdf + (size_t) y * width, (size_t) width);
+	}
+      } else {
+	stbtt_MakeGlyphBitmap(&f->info, b->pixels + p * stride + p, width, height, stride, f->scale, f->scale, glyph);
+      }
+    }
+  }
+  if(sdf) {
+    stbtt_FreeSDF(sdf, f->info.userdata);
+  }
+}
+
+// Places the bitmap into the cache and frees its pixels
+FRAME_DEF Frame_Renderer_Glyph *frame_renderer_glyph_insert(const Frame_Renderer_Font *f, Frame_Renderer_Glyph_Bitmap *b) {
+  Frame_Renderer_Glyph *g = frame_renderer_glyph_alloc(f->id, b->codepoint, f->size, b->width, b->height);
+  if(!g) {
+    FRAME_LOG("Glyph does not fit into the cache: %d\n", b->codepoint);
+  } else {
+    g->xoff = (float) b->x0;
+    g->yoff = (float) b->y0;
+    g->xadvance = b->xadvance;
+    if(g->shelf >= 0 && b->pixels) {
+      frame_renderer_glyph_upload(g, b->pixels);
+    }
+  }
+
+  free(b->pixels);
+  b->pixels = NULL;
+  return g;
+}
+
+// The glyph of the font, rasterized if it was not yet
+FRAME_DEF Frame_Renderer_Glyph *frame_renderer_glyph(const Frame_Renderer_Font *f, int codepoint) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(r->font_index < 0) {
+    return NULL;
+  }
+
+  Frame_Renderer_Glyph *g = frame_renderer_glyph_find(f, codepoint);
+  if(g || !f->rasterize) {
+    return g;
+  }
+
+  Frame_Renderer_Glyph_Bitmap b;
+  b.codepoint = codepoint;
+  frame_renderer_glyph_rasterize(f, &b);
+  return frame_renderer_glyph_insert(f, &b);
+}
+
+// Same as stbtt_GetBakedQuad with opengl fill rules. Distance field glyphs are scaled
+// to the pixel height of the font and not snapped to pixels.
+FRAME_DEF void frame_renderer_glyph_quad(const Frame_Renderer_Font *f, Frame_Renderer_Glyph *g, float *x, float y, stbtt_aligned_quad *q) {
+  float ipw = 1.0f / (float) FRAME_RENDERER_GLYPH_ATLAS_SIZE;
+
+  if(f->sdf) {
+    float k = f->quad_scale;
+    q->x0 = *x + g->xoff * k;
+    q->y0 = y + g->yoff * k;
+    q->x1 = q->x0 + (g->x1 - g->x0) * k;
+    q->y1 = q->y0 + (g->y1 - g->y0) * k;
+    *x += g->xadvance * k;
+  } else {
+    float round_x = floorf(*x + g->xoff + 0.5f);
+    float round_y = floorf(y + g->yoff + 0.5f);
+    q->x0 = round_x;
+    q->y0 = round_y;
+    q->x1 = round_x + g->x1 - g->x0;
+    q->y1 = round_y + g->y1 - g->y0;
+    *x += g->xadvance;
+  }
+  q->s0 = g->x0 * ipw;
+  q->t0 = g->y0 * ipw;
+  q->s1 = g->x1 * ipw;
+  q->t1 = g->y1 * ipw;
+}
+
+// Pen advance of the codepoint, 0 without a glyph
+FRAME_DEF float frame_renderer_glyph_advance(const Frame_Renderer_Font *f, int codepoint) {
+  if(codepoint < FRAME_RENDERER_FONT_TABLE_SIZE) {
+    return f->advances[codepoint];
+  }
+  Frame_Renderer_Glyph *g = frame_renderer_glyph(f, codepoint);
+  if(!g) {
+    return 0;
+  }
+  return f->sdf ? g->xadvance * f->quad_scale : g->xadvance;
+}
+
+// Invalid sequences are U+FFFD, *i is advanced by at least one byte
+FRAME_DEF int frame_renderer_utf8_next(const char *cstr, size_t cstr_len, size_t *i) {
+  const unsigned char *s = (const unsigned char *) cstr + *i;
+  size_t n = cstr_len - *i;
+
+  int c = s[0];
+  int len;
+  int min;
+  if(c < 0x80) {
+    *i += 1;
+    return c;
+  } else if((c & 0xe0) == 0xc0) {
+    len = 2; min = 0x80; c &= 0x1f;
+  } else if((c & 0xf0) == 0xe0) {
+    len = 3; min = 0x800; c &= 0x0f;
+  } else if((c & 0xf8) == 0xf0) {
+    len = 4; min = 0x10000; c &= 0x07;
+  } else {
+    *i += 1;
+    return 0xfffd;
+  }
+
+  for(int k=1;k<len;k++) {
+    if((size_t) k >= n || (s[k] & 0xc0) != 0x80) {
+      *i += k;
+      return 0xfffd;
+    }
+    c = (c << 6) | (s[k] & 0x3f);
+  }
+  *i += len;
+
+  if(c < min || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff)) {
+    return 0xfffd;
+  }
+  return c;
+}
+
+FRAME_DEF Frame_Renderer_Font *frame_renderer_font_get(unsigned int font) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(font >= FRAME_RENDERER_FONTS_CAP || !r->fonts[font].used) {
+    return NULL;
+  }
+  return &r->fonts[font];
+}
+
+// The atlas of the glyph cache is the font texture, it is created with the first font
+FRAME_DEF bool frame_renderer_font_begin(float pixel_height, unsigned int *font) {
+  Frame_Renderer *r = &frame_renderer;
+
+  int index = -1;
+  for(int i=0;i<FRAME_RENDERER_FONTS_CAP && index<0;i++) {
+    if(!r->fonts[i].used) index = i;
+  }
+  if(index < 0) {
+    FRAME_LOG("More than %d fonts\n", FRAME_RENDERER_FONTS_CAP);
+    return false;
+  }
+
+  if(r->font_index < 0) {
+    unsigned int tex;
+    if(!push_texture(FRAME_RENDERER_GLYPH_ATLAS_SIZE, FRAME_RENDERER_GLYPH_ATLAS_SIZE, NULL, true, &tex)) {
+      return false;
+    }
+    frame_renderer_font_use(tex);
+    frame_renderer_glyph_cache_reset();
+  }
+
+  Frame_Renderer_Font *f = &r->fonts[index];
+  memset(f, 0, sizeof(*f));
+  f->used = true;
+  f->id = ++r->font_id;
+  f->height = pixel_height;
+  f->size = pixel_height;
+  f->quad_scale = 1.0f;
+
+  *font = (unsigned int) index;
+  r->font_current = index;
+
+  return true;
+}
+
+FRAME_DEF unsigned int frame_renderer_kern_slot(unsigned int pair, int cap) {
+  return (pair * 0x9e3779b1u >> 16) & (unsigned int) (cap - 1);
+}
+
+FRAME_DEF float frame_renderer_font_kern_scale(const Frame_Renderer_Font *f, int kern) {
+  float xkern = f->scale * (float) kern;
+  return f->sdf ? xkern * f->quad_scale : xkern;
+}
+
+FRAME_DEF bool frame_renderer_font_kern_insert(Frame_Renderer_Font *f, unsigned int pair, float kern) {
+  if(2 * (f->kerning_count + 1) > f->kerning_cap) {
+    int cap = f->kerning_cap > 0 ? f->kerning_cap * 2 : 64;
+    Frame_Renderer_Kern_Pair *kerning = (Frame_Renderer_Kern_Pair *) calloc((size_t) cap, sizeof(*kerning));
+    if(!kerning) {
+      FRAME_LOG("Can not allocate enough memory\n");
+      return false;
+    }
+    for(int i=0;i<f->kerning_cap;i++) {
+      if(f->kerning[i].pair == 0) continue;
+      unsigned int slot = frame_renderer_kern_slot(f->kerning[i].pair, cap);
+      while(kerning[slot].pair != 0) {
+	slot = (slot + 1) & (unsigned int) (cap - 1);
+      }
+      kerning[slot] = f->kerning[i];
+    }
+    free(f->kerning);
+    f->kerning = kerning;
+    f->kerning_cap = cap;
+  }
+
+  unsigned int slot = frame_renderer_kern_slot(pair, f->kerning_cap);
+  while(f->kerning[slot].pair != 0 && f->kerning[slot].pair != pair) {
+    slot = (slot + 1) & (unsigned int) (f->kerning_cap - 1);
+  }
+  if(f->kerning[slot].pair == 0) {
+    f->kerning_count++;
+  }
+  f->kerning[slot].pair = pair;
+  f->kerning[slot].kern = kern;
+  return true;
+}
+
+// The pairs of 'left' with all codepoints of the tables, from GPOS as text asks for them
+FRAME_DEF void frame_renderer_font_kern_row(Frame_Renderer_Font *f, int left) {
+  f->kerning_rows[left / 32] |= 1u << (left % 32);
+
+  int glyph = stbtt_FindGlyphIndex(&f->info, left);
+  for(int right=32;right<FRAME_RENDERER_FONT_TABLE_SIZE;right++) {
+    int kern = stbtt_GetGlyphKernAdvance(&f->info, glyph, stbtt_FindGlyphIndex(&f->info, right));
+    if(kern == 0) continue;
+    if(!frame_renderer_font_kern_insert(f, (unsigned int) left << 8 | (unsigned int) right, frame_renderer_font_kern_scale(f, kern))) {
+      f->kerning_rows[left / 32] &= ~(1u << (left % 32));
+      return;
+    }
+  }
+}
+
+FRAME_DEF int frame_renderer_font_glyph_compare(const void *a, const void *b) {
+  unsigned int x = *(const unsigned int *) a;
+  unsigned int y = *(const unsigned int *) b;
+  return x < y ? -1 : x > y;
+}
+
+// The first of the sorted glyphs that is not below 'key'
+FRAME_DEF int frame_renderer_font_glyph_lower(const unsigned int *glyphs, int n, unsigned int key) {
+  int lo = 0, hi = n;
+  while(lo < hi) {
+    int mid = (lo + hi) / 2;
+    if(glyphs[mid] < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// Advances, metrics and the kerning of the codepoints in the tables
+FRAME_DEF bool frame_renderer_font_tables(Frame_Renderer_Font *f) {
+  int ascent, descent, line_gap;
+  stbtt_GetFontVMetrics(&f->info, &ascent, &descent, &line_gap);
+  float scale = f->scale * f->quad_scale;
+  f->ascent = scale * (float) ascent;
+  f->descent = scale * (float) descent;
+
+  // as frame_renderer_glyph and frame_renderer_glyph_quad do, with glyph << 8 | codepoint
+  // sorted to find the codepoints of a glyph
+  int n = 0;
+  unsigned int glyphs[FRAME_RENDERER_FONT_TABLE_SIZE];
+  for(int c=0;c<FRAME_RENDERER_FONT_TABLE_SIZE;c++) {
+    int glyph = stbtt_FindGlyphIndex(&f->info, c);
+    int advance, lsb;
+    stbtt_GetGlyphHMetrics(&f->info, glyph, &advance, &lsb);
+    float xadvance = f->scale * (float) advance;
+    f->advances[c] = f->sdf ? xadvance * f->quad_scale : xadvance;
+    if(c >= 32) glyphs[n++] = (unsigned int) glyph << 8 | (unsigned int) c;
+  }
+  qsort(glyphs, (size_t) n, sizeof(*glyphs), frame_renderer_font_glyph_compare);
+
+  // GPOS can not be listed, its rows are filled by frame_renderer_font_kern
+  if(f->info.gpos) {
+    memset(f->kerning_rows, 0, sizeof(f->kerning_rows));
+    return true;
+  }
+  memset(f->kerning_rows, 0xff, sizeof(f->kerning_rows));
+
+  int length = stbtt_GetKerningTableLength(&f->info);
+  if(length == 0) {
+    return true;
+  }
+  stbtt_kerningentry *entries = (stbtt_kerningentry *) malloc((size_t) length * sizeof(*entries));
+  if(!entries) {
+    FRAME_LOG("Can not allocate enough memory\n");
+    return false;
+  }
+  length = stbtt_GetKerningTable(&f->info, entries, length);
+
+  for(int i=0;i<length;i++) {
+    if(entries[i].advance == 0) continue;
+
+    int left = frame_renderer_font_glyph_lower(glyphs, n, (unsigned int) entries[i].glyph1 << 8);
+    int right = frame_renderer_font_glyph_lower(glyphs, n, (unsigned int) entries[i].glyph2 << 8);
+    float kern = frame_renderer_font_kern_scale(f, entries[i].advance);
+    for(int a=left;a<n && (glyphs[a] >> 8) == (unsigned int) entries[i].glyph1;a++) {
+      for(int b=right;b<n && (glyphs[b] >> 8) == (unsigned int) entries[i].glyph2;b++) {
+	if(!frame_renderer_font_kern_insert(f, (glyphs[a] & 0xff) << 8 | (glyphs[b] & 0xff), kern)) {
+	  free(entries);
+	  return false;
+	}
+      }
+    }
+  }
+  free(entries);
+
+  return true;
+}
+
+// Pen adjustment between two codepoints, 0 after no codepoint (left < 0)
+FRAME_DEF float frame_renderer_font_kern(Frame_Renderer_Font *f, int left, int right) {
+  if(left < 0) {
+    return 0;
+  }
+
+  if(left < FRAME_RENDERER_FONT_TABLE_SIZE && right < FRAME_RENDERER_FONT_TABLE_SIZE) {
+    if(left < 32 || right < 32) {
+      return 0;
+    }
+    if(f->rasterize && !(f->kerning_rows[left / 32] & (1u << (left % 32)))) {
+      frame_renderer_font_kern_row(f, left);
+    }
+    if(f->kerning_cap == 0) {
+      return 0;
+    }
+    unsigned int pair = (unsigned int) left << 8 | (unsigned int) right;
+    for(unsigned int slot=frame_renderer_kern_slot(pair, f->kerning_cap);;slot=(slot + 1) & (unsigned int) (f->kerning_cap - 1)) {
+      if(f->kerning[slot].pair == pair) return f->kerning[slot].kern;
+      if(f->kerning[slot].pair == 0) return 0;
+    }
+  }
+
+  if(!f->rasterize) {
+    return 0;
+  }
+  return frame_renderer_font_kern_scale(f, stbtt_GetCodepointKernAdvance(&f->info, left, right));
+}
+
+// Does not take the font data, it has to outlive the font
+FRAME_DEF bool frame_renderer_font_parse(const unsigned char *data, float pixel_height, unsigned int *font) {
+  Frame_Renderer *r = &frame_renderer;
+
+  stbtt_fontinfo info;
+  int offset = stbtt_GetFontOffsetForIndex(data, 0);
+  if(offset < 0 || !stbtt_InitFont(&info, data, offset)) {
+    FRAME_LOG("Can not parse font\n");
+    return false;
+  }
+
+  if(!frame_renderer_font_begin(pixel_height, font)) {
+    return false;
+  }
+  Frame_Renderer_Font *f = &r->fonts[*font];
+  f->info = info;
+  f->rasterize = true;
+  if(r->font_flags & FRAME_RENDERER_FONT_SDF) {
+    f->sdf = true;
+    f->size = FRAME_RENDERER_SDF_SIZE;
+    f->quad_scale = pixel_height / FRAME_RENDERER_SDF_SIZE;
+  }
+  f->scale = stbtt_ScaleForPixelHeight(&f->info, f->size);
+
+  if(!frame_renderer_font_tables(f)) {
+    frame_renderer_release_font(*font);
+    return false;
+  }
+
+  return true;
+}
+
+// Takes the font data, also when it fails
+FRAME_DEF bool frame_renderer_font_load(unsigned char *data, float pixel_height, unsigned int *font) {
+  if(!frame_renderer_font_parse(data, pixel_height, font)) {
+    free(data);
+    return false;
+  }
+  frame_renderer.fonts[*font].data = data;
+  return true;
+}
+
+FRAME_DEF void frame_renderer_set_font_flags(int flags) {
+  frame_renderer.font_flags = flags;
+}
+
+FRAME_DEF void frame_renderer_release_font(unsigned int font) {
+  Frame_Renderer *r = &frame_renderer;
+
+  Frame_Renderer_Font *f = frame_renderer_font_get(font);
+  if(!f) {
+    return;
+  }
+
+  // its glyphs on shelves are left to the lru, the others are on none
+  for(int i=0;i<r->glyph_shelves_count;i++) {
+    if(r->glyph_shelves[i].pinned == f->id) r->glyph_shelves[i].pinned = 0;
+  }
+  frame_renderer_glyph_empty_clear(f->id);
+  free(f->data);
+  frame_renderer_file_unmap(&f->map);
+  free(f->kerning);
+  memset(f, 0, sizeof(*f));
+
+  if(r->font_current == (int) font) {
+    r->font_current = -1;
+  }
+}
+
+FRAME_DEF void frame_renderer_set_font(unsigned int font) {
+  if(frame_renderer_font_get(font)) {
+    frame_renderer.font_current = (int) font;
+  }
+}
+
+// Glyphs of a bake are taken one at a time by the workers and the gl thread. The
+// jobs may run after the bake returned, the last one frees it.
+typedef struct{
+  const Frame_Renderer_Font *font;
+  Frame_Renderer_Glyph_Bitmap *bitmaps;
+  LONG count;
+  volatile LONG next;
+  volatile LONG done;
+  int refs; // touched on the gl thread only
+}Frame_Renderer_Font_Bake;
+
+typedef struct{
+  Frame_Renderer_Work work;
+  Frame_Renderer_Font_Bake *bake;
+}Frame_Renderer_Font_Bake_Job;
+
+FRAME_DEF void frame_renderer_font_bake_take(Frame_Renderer_Font_Bake *bake) {
+  while(true) {
+    LONG i = InterlockedIncrement(&bake->next) - 1;
+    if(i >= bake->count) {
+      break;
+    }
+    frame_renderer_glyph_rasterize(bake->font, &bake->bitmaps[i]);
+    InterlockedIncrement(&bake->done);
+  }
+}
+
+FRAME_DEF void frame_renderer_font_bake_release(Frame_Renderer_Font_Bake *bake) {
+  if(--bake->refs == 0) {
+    free(bake);
+  }
+}
+
+FRAME_DEF void frame_renderer_font_bake_job_run(Frame_Renderer_Work *work) {
+  Frame_Renderer_Font_Bake_Job *job = (Frame_Renderer_Font_Bake_Job *) work;
+  frame_renderer_font_bake_take(job->bake);
+}
+
+FRAME_DEF void frame_renderer_font_bake_job_finish(Frame_Renderer_Work *work) {
+  Frame_Renderer_Font_Bake_Job *job = (Frame_Renderer_Font_Bake_Job *) work;
+  frame_renderer_font_bake_release(job->bake);
+  free(job);
+}
+
+FRAME_DEF int frame_renderer_glyph_bitmap_compare(const void *a, const void *b) {
+  const Frame_Renderer_Glyph_Bitmap *x = (const Frame_Renderer_Glyph_Bitmap *) a;
+  const Frame_Renderer_Glyph_Bitmap *y = (const Frame_Renderer_Glyph_Bitmap *) b;
+  if(x->height != y->height) {
+    return y->height - x->height;
+  }
+  return x->codepoint - y->codepoint;
+}
+
+// Rasterizes the bitmaps on the workers and the gl thread
+FRAME_DEF bool frame_renderer_font_rasterize(const Frame_Renderer_Font *f, Frame_Renderer_Glyph_Bitmap *bitmaps, int count) {
+  Frame_Renderer *r = &frame_renderer;
+
+  Frame_Renderer_Font_Bake *bake = (Frame_Renderer_Font_Bake *) malloc(sizeof(*bake));
+  if(!bake) {
+    FRAME_LOG("Can not allocate enough memory\n");
+    return false;
+  }
+  memset(bake, 0, sizeof(*bake));
+  bake->font = f;
+  bake->bitmaps = bitmaps;
+  bake->count = count;
+  bake->refs = 1;
+
+  // one job per worker, a glyph is too little work to queue alone
+  if(count > 1 && frame_renderer_pool_start()) {
+    int jobs = r->pool.threads_count;
+    if(jobs > count - 1) jobs = count - 1;
+    for(int i=0;i<jobs;i++) {
+      Frame_Renderer_Font_Bake_Job *job = (Frame_Renderer_Font_Bake_Job *) malloc(sizeof(*job));
+      if(!job) {
+	break;
+      }
+      memset(job, 0, sizeof(*job));
+      job->work.run = frame_renderer_font_bake_job_run;
+      job->work.finish = frame_renderer_font_bake_job_finish;
+      job->bake = bake;
+      bake->refs++;
+      if(!frame_renderer_pool_submit(&job->work)) {
+	bake->refs--;
+	free(job);
+	break;
+      }
+    }
+  }
+
+  frame_renderer_font_bake_take(bake);
+  while(bake->done < bake->count) {
+    SwitchToThread();
+  }
+  frame_renderer_font_bake_release(bake);
+
+  // tallest first, the shelves fill up without gaps
+  qsort(bitmaps, (size_t) count, sizeof(*bitmaps), frame_renderer_glyph_bitmap_compare);
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_font_bake(unsigned int font, int first, int count, double *ms) {
+
+  LARGE_INTEGER frequency, start, now;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&start);
+
+  Frame_Renderer_Font *f = frame_renderer_font_get(font);
+  if(!f) {
+    FRAME_LOG("Invalid font: %u\n", font);
+    return false;
+  }
+  if(first < 0 || count < 0) {
+    FRAME_LOG("Invalid codepoint range: %d, %d\n", first, count);
+    return false;
+  }
+
+  Frame_Renderer_Glyph_Bitmap *bitmaps = (Frame_Renderer_Glyph_Bitmap *) malloc(sizeof(*bitmaps) * (count > 0 ? count : 1));
+  if(!bitmaps) {
+    FRAME_LOG("Can not allocate enough memory\n");
+    return false;
+  }
+
+  // baked fonts have every glyph they can draw
+  int bitmaps_count = 0;
+  if(f->rasterize) {
+    for(int i=0;i<count;i++) {
+      if(!frame_renderer_glyph_find(f, first + i)) {
+	bitmaps[bitmaps_count++].codepoint = first + i;
+      }
+    }
+  }
+
+  if(!frame_renderer_font_rasterize(f, bitmaps, bitmaps_count)) {
+    free(bitmaps);
+    return false;
+  }
+  bool result = true;
+  for(int i=0;i<bitmaps_count;i++) {
+    if(!frame_renderer_glyph_insert(f, &bitmaps[i])) {
+      result = false;
+    }
+  }
+  free(bitmaps);
+
+  QueryPerformanceCounter(&now);
+  if(ms) {
+    *ms = (double) (now.QuadPart - start.QuadPart) * 1000.0 / (double) frequency.QuadPart;
+  }
+  return result;
+}
+
+FRAME_DEF void frame_renderer_text_effect(float outline, Frame_Renderer_Vec4f outline_color, float glow, Frame_Renderer_Vec4f glow_color) {
+  Frame_Renderer *r = &frame_renderer;
+  Frame_Renderer_Text_Effect *e = &r->text_effect;
+
+  float max = (float) FRAME_RENDERER_SDF_PADDING;
+  outline = outline < 0 ? 0 : outline > max ? max : outline;
+  glow = glow < 0 ? 0 : glow > max ? max : glow;
+  if(e->outline == outline && e->glow == glow &&
+     memcmp(&e->outline_color, &outline_color, sizeof(outline_color)) == 0 &&
+     memcmp(&e->glow_color, &glow_color, sizeof(glow_color)) == 0) {
+    return;
+  }
+
+  // text in the batch keeps its effect
+  frame_renderer_flush(FRAME_RENDERER_FLUSH_STATE);
+  e->outline = outline;
+  e->outline_color = outline_color;
+  e->glow = glow;
+  e->glow_color = glow_color;
+
+  // in units of the distance, see FRAME_RENDERER_SDF_PADDING
+  float o = outline * .5f / max;
+  float g = glow * .5f / max;
+  glUniform1fv(glGetUniformLocation(r->program, "sdf_outline"), 1, &o);
+  glUniform4fv(glGetUniformLocation(r->program, "sdf_outline_color"), 1, &outline_color.x);
+  glUniform1fv(glGetUniformLocation(r->program, "sdf_glow"), 1, &g);
+  glUniform4fv(glGetUniformLocation(r->program, "sdf_glow_color"), 1, &glow_color.x);
+  FRAME_RENDERER_STAT(uniform_updates, 4);
+}
+
+FRAME_DEF bool frame_renderer_push_font(const char *filepath, float pixel_height, unsigned int *font) {
+
+  // glyphs are rasterized from the mapping when they are first drawn, only the pages
+  // they touch are read
+  Frame_Renderer_File_Map map;
+  if(!frame_renderer_file_map(filepath, &map)) {
+    FRAME_LOG("Can not map file: %s\n", filepath);
+    return false;
+  }
+
+  if(!frame_renderer_font_parse(map.view, pixel_height, font)) {
+    FRAME_LOG("Can not load font: %s\n", filepath);
+    frame_renderer_file_unmap(&map);
+    return false;
+  }
+  frame_renderer.fonts[*font].map = map;
+
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_push_font_memory(unsigned char *memory, size_t memory_len, float pixel_height, unsigned int *font) {
+
+  // the caller may free the memory, glyphs are rasterized later
+  unsigned char *data = (unsigned char *) malloc(memory_len);
+  if(!data) {
+    FRAME_LOG("Can not allocate enough memory\n");
+    return false;
+  }
+  memcpy(data, memory, memory_len);
+
+  return frame_renderer_font_load(data, pixel_height, font);
+}
+
+FRAME_DEF bool frame_renderer_push_font_baked(const void *chars, const unsigned char *atlas, int width, int height, float pixel_height, unsigned int *font) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(!frame_renderer_font_begin(pixel_height, font)) {
+    return false;
+  }
+  Frame_Renderer_Font *f = &r->fonts[*font];
+
+  int p = FRAME_RENDERER_GLYPH_PADDING;
+  for(int i=0;i<96;i++) {
+    stbtt_bakedchar b; // 'chars' may not be aligned
+    memcpy(&b, (const unsigned char *) chars + i * sizeof(b), sizeof(b));
+
+    int w = b.x1 - b.x0;
+    int h = b.y1 - b.y0;
+    if(w < 0 || h < 0 || b.x1 > width || b.y1 > height) {
+      FRAME_LOG("Corrupt baked font\n");
+      frame_renderer_release_font(*font);
+      return false;
+    }
+
+    Frame_Renderer_Glyph *g = frame_renderer_glyph_alloc(f->id, 32 + i, pixel_height, w, h);
+    if(!g) {
+      FRAME_LOG("Glyph does not fit into the cache: %d\n", 32 + i);
+      frame_renderer_release_font(*font);
+      return false;
+    }
+    g->xoff = b.xoff;
+    g->yoff = b.yoff;
+    g->xadvance = b.xadvance;
+    f->advances[32 + i] = b.xadvance;
+    if(-b.yoff > f->ascent) f->ascent = -b.yoff;
+    if(-(b.yoff + h) < f->descent) f->descent = -(b.yoff + h);
+    if(g->shelf < 0) {
+      continue;
+    }
+    r->glyph_shelves[g->shelf].pinned = f->id;
+
+    int stride = w + 2 * p;
+    unsigned char *pixels = (unsigned char *) calloc((size_t) stride * (h + 2 * p), 1);
+    if(!pixels) {
+      FRAME_LOG("Can not allocate enough memory\n");
+      frame_renderer_release_font(*font);
+      return false;
+    }
+    for(int y=0;y<h;y++) {
+      memcpy(pixels + (size_t) (y + p) * stride + p, atlas + (size_t) (b.y0 + y) * width + b.x0, (size_t) w);
+    }
+    frame_renderer_glyph_upload(g, pixels);
+    free(pixels);
+  }
+
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_push_font_from_pack(const Frame_Renderer_Pack *pack, const char *name, float pixel_height, unsigned int *font) {
+
+  // baked by tools/pack.c
+  const Frame_Renderer_Pack_Entry *e = frame_renderer_pack_find(pack, name, FRAME_RENDERER_PACK_FONT, pixel_height);
+  if(e) {
+    const unsigned char *data = (const unsigned char *) frame_renderer_pack_data(pack, e);
+    return frame_renderer_push_font_baked(data, data + FRAME_RENDERER_PACK_FONT_CHARS_SIZE, e->width, e->height, pixel_height, font);
+  }
+
+  e = frame_renderer_pack_find(pack, name, FRAME_RENDERER_PACK_FILE, 0);
+  if(e) {
+    return frame_renderer_push_font_memory((unsigned char *) frame_renderer_pack_data(pack, e), (size_t) e->size, pixel_height, font);
+  }
+
+  FRAME_LOG("Asset pack has no font: %s\n", name);
+  return false;
+}
+
+// Font cache
+//   An entry is the header, the advances, the kerning slots, the glyphs and then the rows
+//   of a grey atlas FRAME_RENDERER_GLYPH_ATLAS_SIZE wide. Glyphs are padded in the atlas
+//   and sorted tallest first, as they are inserted into the glyph cache.
+#define FRAME_RENDERER_FONT_CACHE_MAGIC 0x43465246 // 'FRFC'
+#define FRAME_RENDERER_FONT_CACHE_VERSION 1
+
+typedef struct{
+  unsigned int magic;
+  unsigned int version;
+  int flags;
+  float pixel_height;
+  float size, quad_scale;
+  float ascent, descent;
+  int glyphs_count;
+  int kerning_cap;
+  int atlas_height;
+  int reserved;
+  Frame_Renderer_File_Stamp source;
+}Frame_Renderer_Font_Cache_Header;
+
+typedef struct{
+  int codepoint;
+  short x, y; // of the padding in the atlas
+  short width, height;
+  float xoff, yoff, xadvance;
+}Frame_Renderer_Font_Cache_Glyph;
+
+// The path of the entry, and the size and time of the font file
+FRAME_DEF bool frame_renderer_font_cache_entry(const char *filepath, float pixel_height, int flags, const char *dir,
+					       char *entry_path, size_t entry_path_cap, Frame_Renderer_Font_Cache_Header *header) {
+  memset(header, 0, sizeof(*header));
+  if(!frame_renderer_file_stamp(filepath, &header->source)) {
+    return false;
+  }
+
+  char full_path[MAX_PATH];
+  DWORD full_path_len = GetFullPathName(filepath, MAX_PATH, full_path, NULL);
+  if(full_path_len == 0 || full_path_len >= MAX_PATH) {
+    FRAME_LOG("Can not resolve path: %s\n", filepath);
+    return false;
+  }
+  unsigned long long hash = frame_renderer_hash(FRAME_RENDERER_HASH_INIT, full_path, (size_t) full_path_len);
+  hash = frame_renderer_hash(hash, &pixel_height, sizeof(pixel_height));
+  hash = frame_renderer_hash(hash, &flags, sizeof(flags));
+  snprintf(entry_path, entry_path_cap, "%s\\%016llx.frf", dir, hash);
+
+  header->magic = FRAME_RENDERER_FONT_CACHE_MAGIC;
+  header->version = FRAME_RENDERER_FONT_CACHE_VERSION;
+  header->flags = flags;
+  header->pixel_height = pixel_height;
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_save_font_cache(unsigned int font, const char *filepath, const char *dir) {
+  Frame_Renderer *r = &frame_renderer;
+
+  Frame_Renderer_Font *f = frame_renderer_font_get(font);
+  if(!f) {
+    FRAME_LOG("Invalid font: %u\n", font);
+    return false;
+  }
+  if(!f->rasterize) {
+    FRAME_LOG("Baked fonts can not be cached\n");
+    return false;
+  }
+
+  char entry_path[MAX_PATH];
+  Frame_Renderer_Font_Cache_Header header;
+  if(!frame_renderer_font_cache_entry(filepath, f->height, f->sdf ? FRAME_RENDERER_FONT_SDF : 0, dir,
+				      entry_path, sizeof(entry_path), &header) ||
+     !frame_renderer_file_hash(filepath, &header.source.hash)) {
+    return false;
+  }
+
+  // the glyphs it has in the cache, rasterized again as the atlas is not read back
+  int count = 0;
+  for(int i=0;i<FRAME_RENDERER_GLYPHS_CAP;i++) {
+    for(int j=r->glyph_buckets[i];j>=0;j=r->glyphs[j].next) {
+      if(r->glyphs[j].font == f->id && r->glyphs[j].size == f->size) count++;
+    }
+  }
+  Frame_Renderer_Glyph_Bitmap *bitmaps = (Frame_Renderer_Glyph_Bitmap *) malloc(sizeof(*bitmaps) * (count > 0 ? count : 1));
+  if(!bitmaps) {
+    FRAME_LOG("Can not allocate enough memory\n");
+    return false;
+  }
+  count = 0;
+  for(int i=0;i<FRAME_RENDERER_GLYPHS_CAP;i++) {
+    for(int j=r->glyph_buckets[i];j>=0;j=r->glyphs[j].next) {
+      if(r->glyphs[j].font == f->id && r->glyphs[j].size == f->size) bitmaps[count++].codepoint = r->glyphs[j].codepoint;
+    }
+  }
+  if(!frame_renderer_font_rasterize(f, bitmaps, count)) {
+    free(bitmaps);
+    return false;
+  }
+
+  // shelves as the glyph cache packs them
+  int p = FRAME_RENDERER_GLYPH_PADDING;
+  int size = FRAME_RENDERER_GLYPH_ATLAS_SIZE;
+  int x = 0, y = 0, shelf_height = 0;
+  for(int i=0;i<count;i++) {
+    Frame_Renderer_Glyph_Bitmap *b = &bitmaps[i];
+    if(!b->pixels) continue;
+    int width = b->width + 2 * p;
+    if(x + width > size) {
+      y += shelf_height;
+      x = 0;
+      shelf_height = 0;
+    }
+    if(shelf_height == 0) shelf_height = b->height + 2 * p;
+    if(width > size || y + shelf_height > size) {
+      FRAME_LOG("Glyphs do not fit into one atlas: %s\n", filepath);
+      for(int j=0;j<count;j++) free(bitmaps[j].pixels);
+      free(bitmaps);
+      return false;
+    }
+    b->x0 = x; // reused as the place in the atlas
+    b->y0 = y;
+    x += width;
+  }
+
+  // a cached font has no outlines to ask, its kerning has to be complete
+  for(int c=32;c<FRAME_RENDERER_FONT_TABLE_SIZE;c++) {
+    if(!(f->kerning_rows[c / 32] & (1u << (c % 32)))) frame_renderer_font_kern_row(f, c);
+  }
+
+  header.size = f->size;
+  header.quad_scale = f->quad_scale;
+  header.ascent = f->ascent;
+  header.descent = f->descent;
+  header.glyphs_count = count;
+  header.kerning_cap = f->kerning_cap;
+  header.atlas_height = y + shelf_height;
+
+  size_t glyphs_offset = sizeof(header) + sizeof(f->advances) + (size_t) f->kerning_cap * sizeof(Frame_Renderer_Kern_Pair);
+  size_t atlas_offset = glyphs_offset + (size_t) count * sizeof(Frame_Renderer_Font_Cache_Glyph);
+  size_t entry_size = atlas_offset + (size_t) size * header.atlas_height;
+  unsigned char *entry = (unsigned char *) calloc(entry_size, 1);
+  if(!entry) {
+    FRAME_LOG("Can not allocate enough memory\n");
+    for(int i=0;i<count;i++) free(bitmaps[i].pixels);
+    free(bitmaps);
+    return false;
+  }
+  memcpy(entry, &header, sizeof(header));
+  memcpy(entry + sizeof(header), f->advances, sizeof(f->advances));
+  if(f->kerning_cap > 0) {
+    memcpy(entry + sizeof(header) + sizeof(f->advances), f->kerning, (size_t) f->kerning_cap * sizeof(Frame_Renderer_Kern_Pair));
+  }
+
+  Frame_Renderer_Font_Cache_Glyph *glyphs = (Frame_Renderer_Font_Cache_Glyph *) (entry + glyphs_offset);
+  unsigned char *atlas = entry + atlas_offset;
+  for(int i=0;i<count;i++) {
+    Frame_Renderer_Glyph_Bitmap *b = &bitmaps[i];
+    Frame_Renderer_Glyph *g = frame_renderer_glyph_find(f, b->codepoint);
+    Frame_Renderer_Font_Cache_Glyph *c = &glyphs[i];
+    c->codepoint = b->codepoint;
+    c->xoff = g->xoff;
+    c->yoff = g->yoff;
+    c->xadvance = g->xadvance;
+    if(b->pixels) {
+      c->x = (short) b->x0;
+      c->y = (short) b->y0;
+      c->width = (short) b->width;
+      c->height = (short) b->height;
+      int stride = b->width + 2 * p;
+      for(int row=0;row<b->height + 2 * p;row++) {
+	memcpy(atlas + (size_t) (b->y0 + row) * size + b->x0, b->pixels + (size_t) row * stride, (size_t) stride);
+      }
+      free(b->pixels);
+    }
+  }
+  free(bitmaps);
+
+  bool result = frame_renderer_file_replace(entry_path, entry, entry_size, NULL, 0);
+  free(entry);
+  return result;
+}
+
+FRAME_DEF bool frame_renderer_font_cache_check(const Frame_Renderer_Font_Cache_Header *header, size_t size) {
+  if(size < sizeof(*header) ||
+     header->magic != FRAME_RENDERER_FONT_CACHE_MAGIC || header->version != FRAME_RENDERER_FONT_CACHE_VERSION ||
+     header->glyphs_count < 0 || header->glyphs_count > FRAME_RENDERER_GLYPHS_CAP ||
+     header->kerning_cap < 0 || (header->kerning_cap & (header->kerning_cap - 1)) != 0 ||
+     header->atlas_height < 0 || header->atlas_height > FRAME_RENDERER_GLYPH_ATLAS_SIZE) {
+    return false;
+  }
+
+  size_t atlas_offset = sizeof(*header) + FRAME_RENDERER_FONT_TABLE_SIZE * sizeof(float) +
+    (size_t) header->kerning_cap * sizeof(Frame_Renderer_Kern_Pair) +
+    (size_t) header->glyphs_count * sizeof(Frame_Renderer_Font_Cache_Glyph);
+  if(size != atlas_offset + (size_t) FRAME_RENDERER_GLYPH_ATLAS_SIZE * header->atlas_height) {
+    return false;
+  }
+
+  const Frame_Renderer_Font_Cache_Glyph *glyphs = (const Frame_Renderer_Font_Cache_Glyph *) ((const unsigned char *) header + atlas_offset -
+    (size_t) header->glyphs_count * sizeof(Frame_Renderer_Font_Cache_Glyph));
+  int p = FRAME_RENDERER_GLYPH_PADDING;
+  for(int i=0;i<header->glyphs_count;i++) {
+    const Frame_Renderer_Font_Cache_Glyph *c = &glyphs[i];
+    if(c->width < 0 || c->height < 0 || c->x < 0 || c->y < 0 ||
+       c->x + c->width + 2 * p > FRAME_RENDERER_GLYPH_ATLAS_SIZE || c->y + c->height + 2 * p > header->atlas_height) {
+      return false;
+    }
+  }
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_load_font_cache(const char *filepath, float pixel_height, const char *dir, unsigned int *font) {
+  Frame_Renderer *r = &frame_renderer;
+
+  char entry_path[MAX_PATH];
+  Frame_Renderer_Font_Cache_Header source;
+  int flags = r->font_flags & FRAME_RENDERER_FONT_SDF;
+  if(!frame_renderer_font_cache_entry(filepath, pixel_height, flags, dir, entry_path, sizeof(entry_path), &source)) {
+    return false;
+  }
+
+  Frame_Renderer_File_Map map;
+  if(!frame_renderer_file_map(entry_path, &map)) {
+    return false;
+  }
+  const Frame_Renderer_Font_Cache_Header *header = (const Frame_Renderer_Font_Cache_Header *) map.view;
+  if(!frame_renderer_font_cache_check(header, map.size) ||
+     header->flags != flags || header->pixel_height != pixel_height) {
+    FRAME_LOG("Corrupt font cache entry: %s\n", entry_path);
+    frame_renderer_file_unmap(&map);
+    return false;
+  }
+
+  if(!frame_renderer_file_unchanged(filepath, &header->source, &source.source)) {
+    frame_renderer_file_unmap(&map);
+    return false;
+  }
+
+  if(!frame_renderer_font_begin(pixel_height, font)) {
+    frame_renderer_file_unmap(&map);
+    return false;
+  }
+  Frame_Renderer_Font *f = &r->fonts[*font];
+  f->sdf = (flags & FRAME_RENDERER_FONT_SDF) != 0;
+  f->size = header->size;
+  f->quad_scale = header->quad_scale;
+  f->ascent = header->ascent;
+  f->descent = header->descent;
+
+  const unsigned char *at = map.view + sizeof(*header);
+  memcpy(f->advances, at, sizeof(f->advances));
+  at += sizeof(f->advances);
+  if(header->kerning_cap > 0) {
+    f->kerning = (Frame_Renderer_Kern_Pair *) malloc((size_t) header->kerning_cap * sizeof(*f->kerning));
+    if(!f->kerning) {
+      FRAME_LOG("Can not allocate enough memory\n");
+      frame_renderer_release_font(*font);
+      frame_renderer_file_unmap(&map);
+      return false;
+    }
+    memcpy(f->kerning, at, (size_t) header->kerning_cap * sizeof(*f->kerning));
+    f->kerning_cap = header->kerning_cap;
+    for(int i=0;i<f->kerning_cap;i++) {
+      if(f->kerning[i].pair != 0) f->kerning_count++;
+    }
+    at += (size_t) header->kerning_cap * sizeof(*f->kerning);
+  }
+  memset(f->kerning_rows, 0xff, sizeof(f->kerning_rows));
+  const Frame_Renderer_Font_Cache_Glyph *glyphs = (const Frame_Renderer_Font_Cache_Glyph *) at;
+  const unsigned char *atlas = at + (size_t) header->glyphs_count * sizeof(*glyphs);
+
+  // glyphs next to each other in both atlases are uploaded at once
+  int p = FRAME_RENDERER_GLYPH_PADDING;
+  int size = FRAME_RENDERER_GLYPH_ATLAS_SIZE;
+  int run_x = 0, run_y = 0, run_width = 0, run_height = 0, run_shelf = -1;
+  const unsigned char *run_pixels = NULL;
+  const Frame_Renderer_Font_Cache_Glyph *prev = NULL;
+  for(int i=0;i<header->glyphs_count;i++) {
+    const Frame_Renderer_Font_Cache_Glyph *c = &glyphs[i];
+    Frame_Renderer_Glyph *g = frame_renderer_glyph_alloc(f->id, c->codepoint, f->size, c->width, c->height);
+    if(!g) {
+      FRAME_LOG("Glyph does not fit into the cache: %d\n", c->codepoint);
+      frame_renderer_release_font(*font);
+      frame_renderer_file_unmap(&map);
+      return false;
+    }
+    g->xoff = c->xoff;
+    g->yoff = c->yoff;
+    g->xadvance = c->xadvance;
+    if(g->shelf < 0) {
+      continue;
+    }
+    r->glyph_shelves[g->shelf].pinned = f->id;
+
+    int width = c->width + 2 * p;
+    if(run_shelf == g->shelf && run_x + run_width == g->x0 - p &&
+       prev->y == c->y && prev->x + prev->width + 2 * p == c->x) {
+      run_width += width;
+    } else {
+      if(run_shelf >= 0) {
+	frame_renderer_glyph_atlas_upload(run_x, run_y, run_width, run_height, run_pixels, size);
+      }
+      // the tallest glyph of the run is its first
+      run_shelf = g->shelf;
+      run_x = g->x0 - p;
+      run_y = g->y0 - p;
+      run_width = width;
+      run_height = c->height + 2 * p;
+      run_pixels = atlas + (size_t) c->y * size + c->x;
+    }
+    prev = c;
+  }
+  if(run_shelf >= 0) {
+    frame_renderer_glyph_atlas_upload(run_x, run_y, run_width, run_height, run_pixels, size);
+  }
+
+  frame_renderer_file_unmap(&map);
+  return true;
+}
+
+// Bytes of the longest prefix of at most 'cap' bytes that does not split a codepoint
+FRAME_DEF size_t frame_renderer_utf8_prefix(const char *cstr, size_t cstr_len, size_t cap) {
+  if(cstr_len <= cap) {
+    return cstr_len;
+  }
+  size_t n = cap;
+  while(n > 1 && ((unsigned char) cstr[n] & 0xc0) == 0x80) {
+    n--;
+  }
+  return n > 0 ? n : 1;
+}
+
+FRAME_DEF bool frame_renderer_text_run_valid(const Frame_Renderer_Text_Run *run) {
+  Frame_Renderer *r = &frame_renderer;
+
+  for(int i=0;i<run->shelves_count;i++) {
+    const Frame_Renderer_Text_Run_Shelf *s = &run->shelves[i];
+    if(s->index >= r->glyph_shelves_count ||
+       r->glyph_shelves[s->index].generation != s->generation) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Lays the string out starting at the pen position *x after the codepoint *prev. False
+// when a glyph is missing that may be there later, or when it runs out of memory.
+FRAME_DEF bool frame_renderer_text_run_layout(Frame_Renderer_Text_Run *run, Frame_Renderer_Font *f, const char *cstr, size_t cstr_len, float factor, float *x, int *prev) {
+  Frame_Renderer *r = &frame_renderer;
+
+  static const int corners[6] = {0, 1, 3, 0, 2, 3}; // as frame_renderer_quad
+
+  run->verticies_count = 0;
+  run->shelves_count = 0;
+  run->size = vec2f(0, 0);
+
+  bool complete = true;
+  for(size_t i=0;i<cstr_len;) {
+    int c = frame_renderer_utf8_next(cstr, cstr_len, &i);
+    if(c < 32) {
+      continue;
+    }
+    *x += frame_renderer_font_kern(f, *prev, c);
+    *prev = c;
+    Frame_Renderer_Glyph *g = frame_renderer_glyph(f, c);
+    if(!g) {
+      if(f->rasterize) complete = false;
+      continue;
+    }
+
+    stbtt_aligned_quad q;
+    frame_renderer_glyph_quad(f, g, x, 0, &q);
+    if(g->shelf < 0) {
+      continue;
+    }
+
+    if(run->verticies_count + 6 > run->verticies_cap) {
+      int cap = run->verticies_cap > 0 ? run->verticies_cap * 2 : 96;
+      Frame_Renderer_Vertex *verticies = (Frame_Renderer_Vertex *) realloc(run->verticies, cap * sizeof(*verticies));
+      if(!verticies) {
+	return false;
+      }
+      run->verticies = verticies;
+      run->verticies_cap = cap;
+    }
+
+    int shelf = 0;
+    while(shelf < run->shelves_count && run->shelves[shelf].index != g->shelf) {
+      shelf++;
+    }
+    if(shelf == run->shelves_count) {
+      if(run->shelves_count == run->shelves_cap) {
+	int cap = run->shelves_cap > 0 ? run->shelves_cap * 2 : 4;
+	Frame_Renderer_Text_Run_Shelf *shelves = (Frame_Renderer_Text_Run_Shelf *) realloc(run->shelves, cap * sizeof(*shelves));
+	if(!shelves) {
+	  return false;
+	}
+	run->shelves = shelves;
+	run->shelves_cap = cap;
+      }
+      run->shelves[shelf].index = g->shelf;
+      run->shelves[shelf].generation = r->glyph_shelves[g->shelf].generation;
+      run->shelves_count++;
+    }
+
+    Frame_Renderer_Vec2f p = vec2f(q.x0 * factor, -q.y1 * factor);
+    Frame_Renderer_Vec2f s = vec2f((q.x1 - q.x0) * factor, (q.y1 - q.y0) * factor);
+    Frame_Renderer_Vec2f uvp = vec2f(q.s0, 1 - q.t1);
+    if(f->sdf) {
+      uvp.y += 2; // tells the shader
+    }
+    Frame_Renderer_Vec2f uvs = vec2f(q.s1 - q.s0, q.t1 - q.t0);
+
+    Frame_Renderer_Vec2f ps[4] = {p, vec2f(p.x + s.x, p.y), vec2f(p.x, p.y + s.y), vec2f(p.x + s.x, p.y + s.y)};
+    Frame_Renderer_Vec2f uv[4] = {uvp, vec2f(uvp.x + uvs.x, uvp.y), vec2f(uvp.x, uvp.y + uvs.y), vec2f(uvp.x + uvs.x, uvp.y + uvs.y)};
+    Frame_Renderer_Vertex *v = &run->verticies[run->verticies_count];
+    for(int j=0;j<6;j++) {
+      v[j].position = ps[corners[j]];
+      v[j].uv = uv[corners[j]];
+    }
+    run->verticies_count += 6;
+  }
+  run->size = vec2f(*x * factor, (f->ascent - f->descent) * factor);
+
+  return complete;
+}
+
+// Translates the quads of the run to 'pos' and copies them into the batch
+FRAME_DEF void frame_renderer_text_run_draw(const Frame_Renderer_Text_Run *run, Frame_Renderer_Vec2f pos, Frame_Renderer_Vec4f color) {
+  Frame_Renderer *r = &frame_renderer;
+
+  // the batch samples them from now on
+  for(int i=0;i<run->shelves_count;i++) {
+    r->glyph_shelves[run->shelves[i].index].last_used = r->texture_tick;
+  }
+
+  if(r->verticies_count + run->verticies_count >= FRAME_RENDERER_CAP) {
+    frame_renderer_flush(FRAME_RENDERER_FLUSH_CAPACITY);
+  }
+
+  color.w *= -1;
+  Frame_Renderer_Vertex *v = &r->verticies[r->verticies_count];
+  for(int i=0;i<run->verticies_count;i++) {
+    v[i].position = vec2f(pos.x + run->verticies[i].position.x, pos.y + run->verticies[i].position.y);
+    v[i].color = color;
+    v[i].uv = run->verticies[i].uv;
+  }
+  r->verticies_count += run->verticies_count;
+}
+
+// The cached run of the string, laid out now if it was not. NULL when the string is
+// too long or can not be laid out at once.
+FRAME_DEF Frame_Renderer_Text_Run *frame_renderer_text_run(Frame_Renderer_Font *f, const char *cstr, size_t cstr_len, float factor) {
+  Frame_Renderer *r = &frame_renderer;
+
+  if(cstr_len > FRAME_RENDERER_TEXT_RUN_LEN_CAP) {
+    return NULL;
+  }
+  FRAME_RENDERER_STAT(text_runs, 1);
+
+  unsigned long long hash = FRAME_RENDERER_HASH_INIT;
+  hash = frame_renderer_hash(hash, &f->id, sizeof(f->id));
+  hash = frame_renderer_hash(hash, &factor, sizeof(factor));
+  hash = frame_renderer_hash(hash, cstr, cstr_len);
+
+  Frame_Renderer_Text_Run *lru = &r->text_runs[0];
+  for(int i=0;i<FRAME_RENDERER_TEXT_RUNS_CAP;i++) {
+    Frame_Renderer_Text_Run *run = &r->text_runs[i];
+
+    if(run->font == f->id &&
+       run->hash == hash &&
+       run->scale == factor &&
+       run->cstr_len == cstr_len &&
+       memcmp(run->cstr, cstr, cstr_len) == 0) {
+
+      if(frame_renderer_text_run_valid(run)) {
+	FRAME_RENDERER_STAT(text_run_hits, 1);
+	run->last_used = ++r->text_run_tick;
+	return run;
+      }
+      lru = run; // some of its glyphs moved
+      break;
+    }
+
+    if(run->last_used < lru->last_used) {
+      lru = run;
+    }
+  }
+
+  // glyphs of it may have been evicted by later ones
+  float x = 0;
+  int prev = -1;
+  lru->font = 0;
+  if(!frame_renderer_text_run_layout(lru, f, cstr, cstr_len, factor, &x, &prev) ||
+     !frame_renderer_text_run_valid(lru)) {
+    return NULL;
+  }
+  lru->hash = hash;
+  lru->last_used = ++r->text_run_tick;
+  lru->font = f->id;
+  lru->scale = factor;
+  memcpy(lru->cstr, cstr, cstr_len);
+  lru->cstr_len = cstr_len;
+
+  return lru;
+}
+
+// Strings without a cached run are laid out in pieces through the scratch run. Each
+// piece is drawn before the next one can empty a shelf it samples, a piece whose glyphs
+// do not fit into the atlas at once is split.
+FRAME_DEF void frame_renderer_text_pieces(Frame_Renderer_Font *f, const char *cstr, size_t cstr_len, float factor, Frame_Renderer_Vec2f pos, Frame_Renderer_Vec4f color) {
+  Frame_Renderer *r = &frame_renderer;
+  Frame_Renderer_Text_Run *run = &r->text_scratch;
+
+  float x = 0;
+  int prev = -1;
+  for(size_t i=0;i<cstr_len;) {
+    size_t n = frame_renderer_utf8_prefix(cstr + i, cstr_len - i, FRAME_RENDERER_TEXT_RUN_LEN_CAP);
+    float start = x;
+    int start_prev = prev;
+    for(;;) {
+      x = start;
+      prev = start_prev;
+      frame_renderer_text_run_layout(run, f, cstr + i, n, factor, &x, &prev);
+      if(frame_renderer_text_run_valid(run)) {
+	break;
+      }
+      size_t one = 0;
+      frame_renderer_utf8_next(cstr + i, n, &one);
+      if(one >= n) {
+	break;
+      }
+      n = frame_renderer_utf8_prefix(cstr + i, n, n / 2 > one ? n / 2 : one);
+    }
+
+    frame_renderer_text_run_draw(run, pos, color);
+    i += n;
+  }
+}
+
+FRAME_DEF void frame_renderer_font_text(unsigned int font, const char *cstr, size_t cstr_len, Frame_Renderer_Vec2f pos, float factor, Frame_Renderer_Vec4f color) {
+
+  Frame_Renderer_Font *f = frame_renderer_font_get(font);
+  if(!f) {
+    return;
+  }
+
+  Frame_Renderer_Text_Run *run = frame_renderer_text_run(f, cstr, cstr_len, factor);
+  if(run) {
+    frame_renderer_text_run_draw(run, pos, color);
+  } else {
+    frame_renderer_text_pieces(f, cstr, cstr_len, factor, pos, color);
+  }
+}
+
+FRAME_DEF void frame_renderer_text(const char *cstr, size_t cstr_len, Frame_Renderer_Vec2f pos, float factor, Frame_Renderer_Vec4f color) {
+  frame_renderer_font_text((unsigned int) frame_renderer.font_current, cstr, cstr_len, pos, factor, color);
+}
+
+FRAME_DEF bool frame_renderer_text_layout_push(Frame_Renderer_Text_Layout *layout, size_t start, size_t len, float width) {
+  if(layout->lines_count == layout->lines_cap) {
+    int cap = layout->lines_cap > 0 ? layout->lines_cap * 2 : 16;
+    Frame_Renderer_Text_Line *lines = (Frame_Renderer_Text_Line *) realloc(layout->lines, cap * sizeof(*lines));
+    if(!lines) {
+      FRAME_LOG("Can not allocate text lines\n");
+      return false;
+    }
+    layout->lines = lines;
+    layout->lines_cap = cap;
+  }
+
+  Frame_Renderer_Text_Line *line = &layout->lines[layout->lines_count++];
+  line->start = start;
+  line->len = len;
+  line->width = width;
+  if(width > layout->size.x) layout->size.x = width;
+  layout->size.y += layout->line_height;
+
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_font_layout_text(unsigned int font, const char *cstr, size_t cstr_len, float width, float scale, Frame_Renderer_Text_Layout *layout) {
+  layout->font = font;
+  layout->scale = scale;
+  layout->line_height = 0;
+  layout->size = vec2f(0, 0);
+  layout->lines_count = 0;
+
+  Frame_Renderer_Font *f = frame_renderer_font_get(font);
+  if(!f) {
+    return false;
+  }
+  layout->line_height = f->height * scale;
+
+  // pen positions are in pixels of the font
+  size_t start = 0;
+  float x = 0;
+  int prev = -1;
+
+  // the last run of spaces in the line
+  bool space = false;
+  bool breakable = false;
+  size_t break_start = 0, break_end = 0;
+  float break_x = 0, break_end_x = 0;
+
+  for(size_t i=0;i<cstr_len;) {
+    size_t at = i;
+    int c = frame_renderer_utf8_next(cstr, cstr_len, &i);
+    if(c == '\n') {
+      if(!frame_renderer_text_layout_push(layout, start, at - start, x * scale)) {
+	return false;
+      }
+      start = i;
+      x = 0;
+      prev = -1;
+      space = false;
+      breakable = false;
+      continue;
+    }
+    if(c < 32) {
+      continue;
+    }
+
+    float kern = frame_renderer_font_kern(f, prev, c);
+    float advance = frame_renderer_glyph_advance(f, c);
+    prev = c;
+    if(c == ' ') {
+      if(!space) {
+	break_start = at;
+	break_x = x;
+      }
+      space = true;
+      x += kern + advance;
+      break_end = i;
+      breakable = break_start > start; // not at leading spaces
+      continue;
+    }
+    if(space) {
+      break_end_x = x + kern; // a line that starts here has no kerning after the space
+    }
+    space = false;
+
+    while(at > start && (x + kern + advance) * scale > width) {
+      if(breakable) {
+	if(!frame_renderer_text_layout_push(layout, start, break_start - start, break_x * scale)) {
+	  return false;
+	}
+	start = break_end;
+	x -= break_end_x;
+	breakable = false;
+      } else {
+	if(!frame_renderer_text_layout_push(layout, start, at - start, x * scale)) {
+	  return false;
+	}
+	start = at;
+	x = 0;
+	kern = 0;
+      }
+    }
+    x += kern + advance;
+  }
+
+  // nothing after the last '\n'
+  if(start < cstr_len) {
+    return frame_renderer_text_layout_push(layout, start, cstr_len - start, x * scale);
+  }
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_layout_text(const char *cstr, size_t cstr_len, float width, float scale, Frame_Renderer_Text_Layout *layout) {
+  return frame_renderer_font_layout_text((unsigned int) frame_renderer.font_current, cstr, cstr_len, width, scale, layout);
+}
+
+FRAME_DEF void frame_renderer_text_layout_draw(const Frame_Renderer_Text_Layout *layout, const char *cstr, Frame_Renderer_Vec2f pos, Frame_Renderer_Vec4f color) {
+  for(int i=0;i<layout->lines_count;i++) {
+    const Frame_Renderer_Text_Line *line = &layout->lines[i];
+    frame_renderer_font_text(layout->font, cstr + line->start, line->len,
+			     vec2f(pos.x, pos.y - (float) i * layout->line_height),
+			     layout->scale, color);
+  }
+}
+
+FRAME_DEF size_t frame_renderer_text_layout_hit(const Frame_Renderer_Text_Layout *layout, const char *cstr, Frame_Renderer_Vec2f pos, Frame_Renderer_Vec2f point) {
+  if(layout->lines_count == 0 || layout->line_height <= 0) {
+    return 0;
+  }
+
+  // a line reaches from its baseline one line height up
+  float row = floorf((pos.y + layout->line_height - point.y) / layout->line_height);
+  int index = row < 0 ? 0 : (row >= (float) layout->lines_count ? layout->lines_count - 1 : (int) row);
+  const Frame_Renderer_Text_Line *line = &layout->lines[index];
+
+  Frame_Renderer_Font *f = frame_renderer_font_get(layout->font);
+  if(!f) {
+    return line->start;
+  }
+
+  size_t end = line->start + line->len;
+  float x = pos.x;
+  int prev = -1;
+  for(size_t i=line->start;i<end;) {
+    size_t at = i;
+    int c = frame_renderer_utf8_next(cstr, end, &i);
+    if(c < 32) {
+      continue;
+    }
+    float kern = frame_renderer_font_kern(f, prev, c) * layout->scale;
+    float advance = frame_renderer_glyph_advance(f, c) * layout->scale;
+    prev = c;
+    if(point.x < x + kern + advance / 2) {
+      return at;
+    }
+    x += kern + advance;
+  }
+  return end;
+}
+
+FRAME_DEF void frame_renderer_text_layout_free(Frame_Renderer_Text_Layout *layout) {
+  free(layout->lines);
+  memset(layout, 0, sizeof(*layout));
+}
+
+FRAME_DEF bool frame_renderer_text_view_init(Frame_Renderer_Text_View *view, unsigned int font, float width, float scale) {
+  memset(view, 0, sizeof(*view));
+  view->font = font;
+  view->width = width;
+  view->scale = scale;
+
+  Frame_Renderer_Font *f = frame_renderer_font_get(font);
+  if(!f) {
+    return false;
+  }
+  view->line_height = f->height * scale;
+  return true;
+}
+
+// Bytes without a codepoint that is cut off at the end
+FRAME_DEF size_t frame_renderer_utf8_complete(const char *cstr, size_t cstr_len) {
+  for(size_t k=1;k<=3 && k<=cstr_len;k++) {
+    int c = (unsigned char) cstr[cstr_len - k];
+    if((c & 0xc0) == 0x80) continue;
+    int len = c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : c >= 0xc0 ? 2 : 1;
+    return len > (int) k ? cstr_len - k : cstr_len;
+  }
+  return cstr_len;
+}
+
+// Lines from the last line start to the end of the text. A codepoint cut off by the
+// append is left to the next one, it could change where the line breaks.
+FRAME_DEF bool frame_renderer_text_view_layout(Frame_Renderer_Text_View *view) {
+  Frame_Renderer_Text_Layout *layout = &frame_renderer.text_layout;
+
+  size_t start = 0;
+  if(view->lines_count > 0) {
+    start = view->lines[--view->lines_count].start;
+  }
+  size_t len = frame_renderer_utf8_complete(view->text + start, view->text_len - start);
+  if(!frame_renderer_font_layout_text(view->font, view->text + start, len, view->width, view->scale, layout)) {
+    return false;
+  }
+
+  size_t count = layout->lines_count > 0 ? (size_t) layout->lines_count : 1;
+  if(view->lines_count + count > view->lines_cap) {
+    size_t cap = view->lines_cap > 0 ? view->lines_cap : 64;
+    while(cap < view->lines_count + count) cap *= 2;
+    Frame_Renderer_Text_Line *lines = (Frame_Renderer_Text_Line *) realloc(view->lines, cap * sizeof(*lines));
+    if(!lines) {
+      FRAME_LOG("Can not allocate text lines\n");
+      return false;
+    }
+    view->lines = lines;
+    view->lines_cap = cap;
+  }
+  for(int i=0;i<layout->lines_count;i++) {
+    Frame_Renderer_Text_Line *line = &view->lines[view->lines_count++];
+    *line = layout->lines[i];
+    line->start += start;
+  }
+  if(layout->lines_count == 0) {
+    Frame_Renderer_Text_Line *line = &view->lines[view->lines_count++];
+    line->start = start;
+    line->len = 0;
+    line->width = 0;
+  }
+  return true;
+}
+
+FRAME_DEF bool frame_renderer_text_view_append(Frame_Renderer_Text_View *view, const char *cstr, size_t cstr_len) {
+  if(cstr_len == 0) {
+    return true;
+  }
+
+  if(view->text_len + cstr_len > view->text_cap) {
+    size_t cap = view->text_cap > 0 ? view->text_cap : 4096;
+    while(cap < view->text_len + cstr_len) cap *= 2;
+    char *text = (char *) realloc(view->text, cap);
+    if(!text) {
+      FRAME_LOG("Can not allocate enough memory\n");
+      return false;
+    }
+    view->text = text;
+    view->text_cap = cap;
+  }
+  memcpy(view->text + view->text_len, cstr, cstr_len);
+  view->text_len += cstr_len;
+
+  return frame_renderer_text_view_layout(view);
 }
 
-FRAME_DEF bool frame_renderer_create_texture(int width, int height, unsigned int *index) {
-  if(!frame_renderer_push_texture(width, height, NULL, false, index)) {
-    return false;
+FRAME_DEF bool frame_renderer_text_view_set_width(Frame_Renderer_Text_View *view, float width) {
+  if(view->width == width) {
+    return true;
   }
-
+  // kept until the new lines are complete
+  Frame_Renderer_Text_View old = *view;
+  view->width = width;
+  view->lines = NULL;
+  view->lines_count = view->lines_cap = 0;
+
+  // as if it was appended again, the line table of the layout stays small
+  size_t text_len = view->text_len;
+  view->text_len = 0;
+  while(view->text_len < text_len) {
+    view->text_len += text_len - view->text_len < FRAME_RENDERER_TEXT_VIEW_CHUNK ? text_len - view->text_len : FRAME_RENDERER_TEXT_VIEW_CHUNK;
+    if(!frame_renderer_text_view_layout(view)) {
+      free(view->lines);
+      *view = old;
+      return false;
+    }
+  }
+  free(old.lines);
   return true;
 }
 
-FRAME_DEF bool frame_renderer_push_to_texture(unsigned int tex, const void *data, int x_off, int y_off, int width, int height) {
-  Frame_Renderer *r = &frame_renderer;
-  
-  if(tex >= r->images_count) return false;
-  
-  GLenum current_texture;
-  switch(tex) {
-  case 0:
-    current_texture = GL_TEXTURE0;
-    break;
-  case 1:
-    current_texture = GL_TEXTURE1;
-    break;
-  case 2:
-    current_texture = GL_TEXTURE2;
-    break;
-  case 3:
-    current_texture = GL_TEXTURE3;
-    break;
-  default:
-    return false;
+FRAME_DEF void frame_renderer_text_view_draw(const Frame_Renderer_Text_View *view, Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s, double scroll, Frame_Renderer_Vec4f color) {
+  Frame_Renderer_Font *f = frame_renderer_font_get(view->font);
+  if(!f || view->lines_count == 0 || view->line_height <= 0) {
+    return;
   }
 
-  glActiveTexture(current_texture);
-  
-  glTexSubImage2D(GL_TEXTURE_2D,
-		  0,
-		  x_off, y_off,
-		  width, height,
-		  GL_RGBA,
-		  GL_UNSIGNED_INT_8_8_8_8_REV,
-		  data);
+  if(scroll < 0) scroll = 0;
+  size_t first = (size_t) (scroll / view->line_height);
+  size_t last = (size_t) ((scroll + s.y) / view->line_height) + 1;
+  if(last > view->lines_count) last = view->lines_count;
+
+  for(size_t i=first;i<last;i++) {
+    const Frame_Renderer_Text_Line *line = &view->lines[i];
+    // relative to the scroll offset, a float has no room for both. pos is the baseline,
+    // descent is below it.
+    float below = (float) ((double) (i + 1) * view->line_height - scroll);
+    float y = p.y + s.y - below - f->descent * view->scale;
+    frame_renderer_font_text(view->font, view->text + line->start, line->len, vec2f(p.x, y), view->scale, color);
+  }
+}
 
-  return true;
+FRAME_DEF void frame_renderer_text_view_free(Frame_Renderer_Text_View *view) {
+  free(view->text);
+  free(view->lines);
+  memset(view, 0, sizeof(*view));
 }
 
-FRAME_DEF bool frame_renderer_push_texture(int width, int height, const void *data, bool grey, unsigned int *index) {
+FRAME_DEF void frame_renderer_font_text_wrapped(unsigned int font, const char *cstr, size_t cstr_len, Frame_Renderer_Vec2f *pos, Frame_Renderer_Vec2f size, float scale, Frame_Renderer_Vec4f color) {
+  Frame_Renderer_Text_Layout *layout = &frame_renderer.text_layout;
 
-  Frame_Renderer *r = &frame_renderer;
+  if(!frame_renderer_font_layout_text(font, cstr, cstr_len, size.x, scale, layout)) {
+    return;
+  }
+  frame_renderer_text_layout_draw(layout, cstr, *pos, color);
+  pos->y -= layout->size.y;
+}
 
-  GLenum current_texture;
-  switch(r->images_count) {
-  case 0:
-    current_texture = GL_TEXTURE0;
-    break;
-  case 1:
-    current_texture = GL_TEXTURE1;
-    break;
-  case 2:
-    current_texture = GL_TEXTURE2;
-    break;
-  case 3:
-    current_texture = GL_TEXTURE3;
-    break;
-  default:
-    return false;
+FRAME_DEF void frame_renderer_text_wrapped(const char *cstr, size_t cstr_len, Frame_Renderer_Vec2f *pos, Frame_Renderer_Vec2f size, float scale, Frame_Renderer_Vec4f color) {
+  frame_renderer_font_text_wrapped((unsigned int) frame_renderer.font_current, cstr, cstr_len, pos, size, scale, color);
+}
+
+FRAME_DEF bool frame_renderer_text_button(const char *cstr, size_t cstr_len, float scale, Frame_Renderer_Vec4f text_color, Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s, Frame_Renderer_Vec4f c) {
+  bool holding = frame_renderer_button_impl(p, s, &c);
+  frame_renderer_solid_rect(p, s, c);
+  if(holding) {
+    text_color.w *= .5;
+  }
+
+  // measured and drawn with one layout
+  Frame_Renderer_Font *f = frame_renderer_font_get((unsigned int) frame_renderer.font_current);
+  Frame_Renderer_Text_Run *run = f ? frame_renderer_text_run(f, cstr, cstr_len, scale) : NULL;
+
+  Vec2f size;
+  if(run) {
+    size = run->size;
+  } else {
+    frame_renderer_measure_text(cstr, cstr_len, scale, &size);
+  }
+
+  if(size.x <= s.x && size.y <= s.y) {
+    // pos is the baseline, descent is below it
+    Vec2f pos = vec2f(p.x + s.x / 2 - size.x / 2,
+		      p.y + s.y / 2 - size.y / 2 - (f ? f->descent * scale : 0));
+    if(run) {
+      frame_renderer_text_run_draw(run, pos, text_color);
+    } else {
+      frame_renderer_text(cstr, cstr_len, pos, scale, text_color);
+    }
   }
   
-  glActiveTexture(current_texture);
-  
-  glGenTextures(1, &r->textures);
-  glBindTexture(GL_TEXTURE_2D, r->textures);
+  return frame_renderer.released && holding;
+}
 
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+// A sum over the tables, no glyph is looked up for the codepoints in them
+FRAME_DEF void frame_renderer_font_measure_text(unsigned int font, const char *cstr, size_t cstr_len, float factor, Vec2f *size) {
 
-  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  size->y = 0;
+  size->x = 0;
 
-  if(grey) {
-    glTexImage2D(GL_TEXTURE_2D,
-		 0,
-		 GL_ALPHA,
-		 width,
-		 height,
-		 0,
-		 GL_ALPHA,
-		 GL_UNSIGNED_BYTE,
-		 data);	
-  } else {
-    glTexImage2D(GL_TEXTURE_2D,
-		 0,
-		 GL_RGBA,
-		 width,
-		 height,
-		 0,
-		 GL_RGBA,
-		 GL_UNSIGNED_INT_8_8_8_8_REV,
-		 data);
+  Frame_Renderer_Font *f = frame_renderer_font_get(font);
+  if(!f) {
+    return;
+  }
+
+  float x = 0;
+  int prev = -1;
+  for(size_t i=0;i<cstr_len;) {
+    int c = (unsigned char) cstr[i];
+    if(c < 0x80) {
+      i++;
+    } else {
+      c = frame_renderer_utf8_next(cstr, cstr_len, &i);
+    }
+    if(c < 32) {
+      continue;
+    }
+    x += frame_renderer_font_kern(f, prev, c);
+    x += frame_renderer_glyph_advance(f, c);
+    prev = c;
   }
 
-  *index = r->images_count++;
+  size->x = x * factor;
+  size->y = (f->ascent - f->descent) * factor;
+}
 
-  return true;
+FRAME_DEF void frame_renderer_measure_text(const char *cstr, size_t cstr_len, float factor, Vec2f *size) {
+  frame_renderer_font_measure_text((unsigned int) frame_renderer.font_current, cstr, cstr_len, factor, size);
 }
 
-#ifdef FRAME_STB_TRUETYPE
-#include <stdio.h>
+#endif //FRAME_STB_TRUETYPE
+
+#ifdef FRAME_STB_IMAGE
 
-#define FRAME_RENDERER_STB_TEMP_BITMAP_SIZE 1024
+// Image cache
+//   Entries are named by the hash of the full path of the source and hold the decoded
+//   rgba after a header. A hit is mapped and uploaded as it is.
+#define FRAME_RENDERER_IMAGE_CACHE_MAGIC 0x43495246 // 'FRIC'
+#define FRAME_RENDERER_IMAGE_CACHE_VERSION 1
 
-FRAME_DEF bool frame_renderer_push_font(const char *filepath, float pixel_height) {
+typedef struct{
+  unsigned int magic;
+  unsigned int version;
+  int width, height;
+  Frame_Renderer_File_Stamp source;
+}Frame_Renderer_Image_Cache_Header;
+
+typedef struct{
+  int width, height;
+  const unsigned char *pixels; // rgba
+  unsigned char *decoded;      // from stbi, or
+  Frame_Renderer_File_Map map; // a mapped cache entry
+}Frame_Renderer_Image;
 
-  HANDLE handle = CreateFile(filepath, GENERIC_READ,
-			 FILE_SHARE_READ,
-			 NULL,
-			 OPEN_EXISTING,
-			 FILE_ATTRIBUTE_NORMAL,
-			 NULL);
+FRAME_DEF bool frame_renderer_image_cache_read(const char *filepath, unsigned char **data, size_t *data_len) {
+  HANDLE handle = CreateFile(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
   if(handle == INVALID_HANDLE_VALUE) {
     FRAME_LOG("Can not open file: %s\n", filepath);
-    return false;    
+    return false;
   }
 
   DWORD m = GetFileSize(handle, NULL);
@@ -1522,194 +6973,244 @@ FRAME_DEF bool frame_renderer_push_font(const char *filepath, float pixel_height
     return false;
   }
 
-  unsigned char *buffer = (unsigned char *) malloc((size_t) m);
-  if(!buffer) {
+  *data = (unsigned char *) malloc(m > 0 ? (size_t) m : 1);
+  if(!*data) {
     FRAME_LOG("Can not allocate enough memory\n");
     CloseHandle(handle);
     return false;
   }
 
   DWORD n;
-  if(!ReadFile(handle, buffer, m, &n, NULL) || n != m) {
-    FRAME_LOG("Failed to read from file: %s\n", filepath);	
-    free(buffer);
+  if(!ReadFile(handle, *data, m, &n, NULL) || n != m) {
+    FRAME_LOG("Failed to read from file: %s\n", filepath);
+    free(*data);
     CloseHandle(handle);
+    return false;
   }
-
   CloseHandle(handle);
-  
-  unsigned char *temp_bitmap = malloc(FRAME_RENDERER_STB_TEMP_BITMAP_SIZE *
-				      FRAME_RENDERER_STB_TEMP_BITMAP_SIZE);
-  
-  Frame_Renderer *r = &frame_renderer;
-  stbtt_BakeFontBitmap(buffer, 0, pixel_height,
-		       temp_bitmap,
-		       FRAME_RENDERER_STB_TEMP_BITMAP_SIZE,
-		       FRAME_RENDERER_STB_TEMP_BITMAP_SIZE,
-		       32, 96, r->font_cdata);
-
-  unsigned int tex;
-  bool result = push_texture(1024, 1024, temp_bitmap, true, &tex);
 
-  r->font_index = (int) tex;
-  r->font_height = pixel_height;
-
-  free(buffer);
-  free(temp_bitmap);
-    
-  return result;
-  
+  *data_len = (size_t) m;
+  return true;
 }
 
-FRAME_DEF bool frame_renderer_push_font_memory(unsigned char *memory, size_t memory_len, float pixel_height) {
-  (void) memory_len;
-  
-  unsigned char *temp_bitmap = malloc(FRAME_RENDERER_STB_TEMP_BITMAP_SIZE *
-				      FRAME_RENDERER_STB_TEMP_BITMAP_SIZE);
-  
-  Frame_Renderer *r = &frame_renderer;
-  stbtt_BakeFontBitmap(memory, 0, pixel_height,
-		       temp_bitmap,
-		       FRAME_RENDERER_STB_TEMP_BITMAP_SIZE,
-		       FRAME_RENDERER_STB_TEMP_BITMAP_SIZE,
-		       32, 96, r->font_cdata);
+FRAME_DEF void frame_renderer_image_close(Frame_Renderer_Image *image) {
+  frame_renderer_file_unmap(&image->map);
+  if(image->decoded) stbi_image_free(image->decoded);
+  memset(image, 0, sizeof(*image));
+}
 
-  unsigned int tex;
-  bool result = push_texture(1024, 1024, temp_bitmap, true, &tex);
+FRAME_DEF bool frame_renderer_image_cache_map(const char *entry_path, Frame_Renderer_Image *image) {
+  if(!frame_renderer_file_map(entry_path, &image->map)) {
+    return false;
+  }
 
-  r->font_index = (int) tex;
-  r->font_height = pixel_height;
+  const Frame_Renderer_Image_Cache_Header *header = (const Frame_Renderer_Image_Cache_Header *) image->map.view;
+  if(image->map.size < sizeof(*header) ||
+     header->magic != FRAME_RENDERER_IMAGE_CACHE_MAGIC ||
+     header->version != FRAME_RENDERER_IMAGE_CACHE_VERSION ||
+     header->width <= 0 || header->height <= 0 ||
+     image->map.size != sizeof(*header) + (size_t) header->width * header->height * 4) {
+    frame_renderer_image_close(image);
+    return false;
+  }
 
-  free(temp_bitmap);
-    
-  return result;
+  image->width = header->width;
+  image->height = header->height;
+  image->pixels = image->map.view + sizeof(*header);
+  return true;
 }
 
-FRAME_DEF void frame_renderer_text(const char *cstr, size_t cstr_len, Frame_Renderer_Vec2f pos, float factor, Frame_Renderer_Vec4f color) {
-
-  Frame_Renderer *r = &frame_renderer;
+// a hit becomes the most recently used entry, with the time of the source it was checked against
+FRAME_DEF void frame_renderer_image_cache_touch(const char *entry_path, const Frame_Renderer_Image *image, unsigned long long source_time) {
+  HANDLE handle = CreateFile(entry_path, GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+			     OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if(handle == INVALID_HANDLE_VALUE) {
+    return;
+  }
 
-  float x = 0;
-  float y = 0;
-  color.w *= -1;
-    
-  for(size_t i=0;i<cstr_len;i++) {
-    unsigned char c = cstr[i];
-    if (c < 32 && c >= 128) {
-      continue;
-    }
+  const Frame_Renderer_Image_Cache_Header *header = (const Frame_Renderer_Image_Cache_Header *) image->map.view;
+  if(header->source.time != source_time) {
+    DWORD n;
+    LONG offset = (LONG) (offsetof(Frame_Renderer_Image_Cache_Header, source) + offsetof(Frame_Renderer_File_Stamp, time));
+    SetFilePointer(handle, offset, NULL, FILE_BEGIN);
+    WriteFile(handle, &source_time, sizeof(source_time), &n, NULL);
+  }
 
-    float _y = y;
+  FILETIME now;
+  GetSystemTimeAsFileTime(&now);
+  SetFileTime(handle, NULL, NULL, &now);
+  CloseHandle(handle);
+}
 
-    stbtt_aligned_quad q;
-    stbtt_GetBakedQuad(r->font_cdata,
-		       FRAME_RENDERER_STB_TEMP_BITMAP_SIZE,
-		       FRAME_RENDERER_STB_TEMP_BITMAP_SIZE, c-32, &x, &y, &q,1);
-    //1=opengl & d3d10+,0=d3d9
+// removes the least recently written entries until the directory fits into the cap
+FRAME_DEF void frame_renderer_image_cache_trim() {
+  Frame_Renderer *r = &frame_renderer;
 
+  r->image_cache_stored = false;
+  if(!r->image_cache_dir[0] || r->image_cache_cap == 0) {
+    return;
+  }
 
-    Frame_Renderer_Vec2f p = vec2f(pos.x + q.x0 * factor,pos.y + y + _y + factor * (y - q.y1) );
-    Frame_Renderer_Vec2f s = vec2f((q.x1 - q.x0) * factor, (q.y1 - q.y0) * factor);
-    Frame_Renderer_Vec2f uvp = vec2f(q.s0, 1 - q.t1);
-    Frame_Renderer_Vec2f uvs = vec2f(q.s1 - q.s0, q.t1 - q.t0);
-	
-    frame_renderer_quad(
-			 p,
-			 frame_renderer_vec2f(p.x + s.x, p.y),
-			 frame_renderer_vec2f(p.x, p.y + s.y),
-			 frame_renderer_vec2f(p.x + s.x, p.y + s.y),
-			 color, color, color, color,
-			 uvp,
-			 frame_renderer_vec2f(uvp.x + uvs.x, uvp.y),
-			 frame_renderer_vec2f(uvp.x, uvp.y + uvs.y),
-			 frame_renderer_vec2f(uvp.x + uvs.x, uvp.y + uvs.y));
+  char pattern[MAX_PATH];
+  snprintf(pattern, sizeof(pattern), "%s\\*.fri", r->image_cache_dir);
+
+  typedef struct{
+    char name[MAX_PATH];
+    unsigned long long size;
+    FILETIME time;
+  }Entry;
+  Entry *entries = NULL;
+  size_t entries_count = 0, entries_cap = 0;
+  unsigned long long total = 0;
+
+  WIN32_FIND_DATA data;
+  HANDLE find = FindFirstFile(pattern, &data);
+  if(find == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  do {
+    if(entries_count == entries_cap) {
+      entries_cap = entries_cap ? entries_cap * 2 : 64;
+      Entry *new_entries = (Entry *) realloc(entries, entries_cap * sizeof(Entry));
+      if(!new_entries) {
+	break;
+      }
+      entries = new_entries;
+    }
+    Entry *e = &entries[entries_count++];
+    snprintf(e->name, sizeof(e->name), "%s\\%s", r->image_cache_dir, data.cFileName);
+    e->size = ((unsigned long long) data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    e->time = data.ftLastWriteTime;
+    total += e->size;
+  } while(FindNextFile(find, &data));
+  FindClose(find);
+
+  while(total > r->image_cache_cap && entries_count > 0) {
+    size_t oldest = 0;
+    for(size_t i=1;i<entries_count;i++) {
+      if(CompareFileTime(&entries[i].time, &entries[oldest].time) < 0) oldest = i;
+    }
+    // an entry that can not be deleted right now still counts
+    if(DeleteFile(entries[oldest].name)) {
+      total -= entries[oldest].size;
+    }
+    entries[oldest] = entries[--entries_count];
   }
 
+  free(entries);
 }
 
-FRAME_DEF void frame_renderer_text_wrapped(const char *cstr, size_t cstr_len, Frame_Renderer_Vec2f *pos, Frame_Renderer_Vec2f size, float scale, Frame_Renderer_Vec4f color) {
+// one scan of the directory for all entries written by a batch of loads
+FRAME_DEF void frame_renderer_image_cache_update() {
   Frame_Renderer *r = &frame_renderer;
-  Vec2f text_size;
-  
-  size_t i = 0;
-  while(i < cstr_len) {
-    size_t j=1;
-    for(;j<cstr_len - i;j++) {
-      measure_text_len(cstr + i, j, scale, &text_size);
-      if(text_size.x >= size.x) break;
-    }
 
-    draw_text_len_colored(cstr + i, j, *pos, scale, color);
-    i += j;
-    pos->y -= r->font_height * scale;    
+  if(r->image_cache_stored && r->image_jobs == 0) {
+    frame_renderer_image_cache_trim();
   }
 }
 
-FRAME_DEF bool frame_renderer_text_button(const char *cstr, size_t cstr_len, float scale, Frame_Renderer_Vec4f text_color, Frame_Renderer_Vec2f p, Frame_Renderer_Vec2f s, Frame_Renderer_Vec4f c) {
-  bool holding = frame_renderer_button_impl(p, s, &c);
-  frame_renderer_solid_rect(p, s, c);
-  if(holding) {
-    text_color.w *= .5;
+// Decoded rgba of 'filepath', from the image cache in 'cache_dir' unless it is empty. Touches
+// no state of the renderer, the workers run it. 'stored' tells whether an entry was written.
+FRAME_DEF bool frame_renderer_image_load(const char *filepath, const char *cache_dir, Frame_Renderer_Image *image, bool *stored) {
+
+  *stored = false;
+  memset(image, 0, sizeof(*image));
+  if(!cache_dir[0]) {
+    image->decoded = stbi_load(filepath, &image->width, &image->height, NULL, 4);
+    image->pixels = image->decoded;
+    return image->decoded != NULL;
   }
 
-  Vec2f size;
-  frame_renderer_measure_text(cstr, cstr_len, scale, &size);
+  Frame_Renderer_File_Stamp source;
+  if(!frame_renderer_file_stamp(filepath, &source)) {
+    return false;
+  }
 
-  if(size.x <= s.x && size.y <= s.y) {
-    Vec2f pos = vec2f(p.x + s.x / 2 - size.x / 2,
-		      p.y + s.y / 2 - size.y / 2);
-    frame_renderer_text(cstr, cstr_len, pos, scale, text_color);
+  char full_path[MAX_PATH];
+  DWORD full_path_len = GetFullPathName(filepath, MAX_PATH, full_path, NULL);
+  if(full_path_len == 0 || full_path_len >= MAX_PATH) {
+    FRAME_LOG("Can not resolve path: %s\n", filepath);
+    return false;
+  }
+  char entry_path[MAX_PATH];
+  snprintf(entry_path, sizeof(entry_path), "%s\\%016llx.fri", cache_dir,
+	   frame_renderer_hash(FRAME_RENDERER_HASH_INIT, full_path, (size_t) full_path_len));
+
+  if(frame_renderer_image_cache_map(entry_path, image)) {
+    const Frame_Renderer_Image_Cache_Header *header = (const Frame_Renderer_Image_Cache_Header *) image->map.view;
+    if(frame_renderer_file_unchanged(filepath, &header->source, &source)) {
+      frame_renderer_image_cache_touch(entry_path, image, source.time);
+      return true;
+    }
+    frame_renderer_image_close(image);
   }
-  
-  return frame_renderer.released && holding;
-}
 
-FRAME_DEF void frame_renderer_measure_text(const char *cstr, size_t cstr_len, float factor, Vec2f *size) {
-  Frame_Renderer *r = &frame_renderer;
+  unsigned char *data;
+  size_t data_len;
+  if(!frame_renderer_image_cache_read(filepath, &data, &data_len)) {
+    return false;
+  }
+  source.hash = frame_renderer_hash(FRAME_RENDERER_HASH_INIT, data, data_len);
 
-  float hi = 0;
-  float lo = 0;
+  image->decoded = stbi_load_from_memory(data, (int) data_len, &image->width, &image->height, NULL, 4);
+  free(data);
+  if(!image->decoded) {
+    return false;
+  }
+  image->pixels = image->decoded;
 
-  size->y = 0;
-  size->x = 0;
+  Frame_Renderer_Image_Cache_Header header;
+  memset(&header, 0, sizeof(header));
+  header.magic = FRAME_RENDERER_IMAGE_CACHE_MAGIC;
+  header.version = FRAME_RENDERER_IMAGE_CACHE_VERSION;
+  header.width = image->width;
+  header.height = image->height;
+  header.source = source;
+  *stored = frame_renderer_file_replace(entry_path, &header, sizeof(header), image->pixels, (size_t) image->width * image->height * 4);
 
-  float x = 0;
-  float y = 0;
-    
-  for(size_t i=0;i<cstr_len;i++) {
-    unsigned char c = cstr[i];
-    if (c < 32 && c >= 128) {
-      continue;
-    }
+  return true;
+}
 
-    stbtt_aligned_quad q;
-    stbtt_GetBakedQuad(r->font_cdata,
-		       FRAME_RENDERER_STB_TEMP_BITMAP_SIZE,
-		       FRAME_RENDERER_STB_TEMP_BITMAP_SIZE,
-		       c-32, &x, &y, &q, 1);
+FRAME_DEF bool frame_renderer_set_image_cache(const char *dir, size_t cap) {
+  Frame_Renderer *r = &frame_renderer;
 
-    size->x = q.y1 - q.y0;
-    float height = q.x1 - q.x0;
-    if(height > hi) hi = height;
-    if(height < lo) lo = height;
+  if(!dir) {
+    r->image_cache_dir[0] = 0;
+    return true;
   }
-  size->x = x * factor;  
-  size->y = (hi - lo) * factor;
-}
 
-#endif //FRAME_STB_TRUETYPE
+  size_t dir_len = strlen(dir);
+  if(dir_len == 0 || dir_len + 32 >= sizeof(r->image_cache_dir)) {
+    FRAME_LOG("Image cache path is too long: %s\n", dir);
+    return false;
+  }
+  if(!CreateDirectory(dir, NULL) && GetLastError() != ERROR_ALREADY_EXISTS) {
+    FRAME_LOG("Can not create directory: %s\n", dir);
+    return false;
+  }
 
-#ifdef FRAME_STB_IMAGE
+  memcpy(r->image_cache_dir, dir, dir_len + 1);
+  r->image_cache_cap = cap;
+  frame_renderer_image_cache_trim();
+
+  return true;
+}
 
 FRAME_DEF bool frame_renderer_push_image(const char *filepath, int *width, int *height, unsigned int *index) {
+  Frame_Renderer *r = &frame_renderer;
 
-  unsigned char *image_data = stbi_load(filepath, width, height, NULL, 4);
-  if(image_data == NULL) {
+  Frame_Renderer_Image image;
+  bool stored;
+  bool loaded = frame_renderer_image_load(filepath, r->image_cache_dir, &image, &stored);
+  if(stored) r->image_cache_stored = true;
+  if(!loaded) {
     return false;
   }
+  *width = image.width;
+  *height = image.height;
 
-  bool result = frame_renderer_push_texture(*width, *height, image_data, false, index);
-  stbi_image_free(image_data);
+  bool result = frame_renderer_push_texture(image.width, image.height, image.pixels, false, index);
+  frame_renderer_image_close(&image);
 
   return result;
 }
@@ -1726,6 +7227,90 @@ FRAME_DEF bool frame_renderer_push_image_memory(unsigned char *data, size_t data
   return result;
 }
 
+typedef struct{
+  Frame_Renderer_Work work;
+  unsigned int texture;
+  int flags;
+  Frame_Renderer_Image image;
+  bool loaded, stored;
+  char cache_dir[MAX_PATH]; // as it was when the job was submitted
+  char filepath[];
+}Frame_Renderer_Image_Job;
+
+FRAME_DEF void frame_renderer_image_job_run(Frame_Renderer_Work *work) {
+  Frame_Renderer_Image_Job *job = (Frame_Renderer_Image_Job *) work;
+  job->loaded = frame_renderer_image_load(job->filepath, job->cache_dir, &job->image, &job->stored);
+}
+
+FRAME_DEF void frame_renderer_image_job_finish(Frame_Renderer_Work *work) {
+  Frame_Renderer *r = &frame_renderer;
+  Frame_Renderer_Image_Job *job = (Frame_Renderer_Image_Job *) work;
+
+  r->image_jobs--;
+  if(job->stored) r->image_cache_stored = true;
+
+  // a cancelled job has no slot anymore
+  if(!work->cancelled) {
+    Frame_Renderer_Texture *t = &r->textures[job->texture];
+    t->loading = false;
+    t->work = NULL;
+
+    if(!job->loaded) {
+      FRAME_LOG("Can not load image: %s\n", job->filepath);
+      t->failed = true;
+    } else if(!frame_renderer_texture_init(job->texture, job->image.width, job->image.height, job->image.pixels, false, job->flags)) {
+      t = &r->textures[job->texture];
+      memset(t, 0, sizeof(*t));
+      t->used = true;
+      t->page = -1;
+      t->failed = true;
+    }
+  }
+
+  frame_renderer_image_close(&job->image);
+  free(job);
+}
+
+FRAME_DEF bool frame_renderer_push_image_async(const char *filepath, unsigned int *index) {
+  Frame_Renderer *r = &frame_renderer;
+
+  size_t filepath_len = strlen(filepath);
+  Frame_Renderer_Image_Job *job = (Frame_Renderer_Image_Job *) malloc(sizeof(*job) + filepath_len + 1);
+  if(!job) {
+    FRAME_LOG("Can not allocate enough memory\n");
+    return false;
+  }
+  memset(job, 0, sizeof(*job));
+  memcpy(job->filepath, filepath, filepath_len + 1);
+  memcpy(job->cache_dir, r->image_cache_dir, sizeof(job->cache_dir));
+  job->work.run = frame_renderer_image_job_run;
+  job->work.finish = frame_renderer_image_job_finish;
+  job->flags = r->texture_flags;
+
+  unsigned int texture;
+  if(!frame_renderer_texture_alloc(&texture)) {
+    free(job);
+    return false;
+  }
+  Frame_Renderer_Texture *t = &r->textures[texture];
+  memset(t, 0, sizeof(*t));
+  t->used = true;
+  t->page = -1;
+  t->loading = true;
+  t->work = &job->work;
+  job->texture = texture;
+
+  if(!frame_renderer_pool_submit(&job->work)) {
+    t->used = false;
+    free(job);
+    return false;
+  }
+  r->image_jobs++;
+
+  *index = texture;
+  return true;
+}
+
 #endif // FRAME_STB_IMAGE
 
 #endif //FRAME_NO_RENDERER
@@ -1888,6 +7473,101 @@ void glCreateTextures(GLenum target, GLsizei n, GLuint *textures) {
   _glCreateTextures(target, n, textures);
 }
 
+PROC _glStencilOpSeparate = NULL;
+void glStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass) {
+  _glStencilOpSeparate(face, sfail, dpfail, dppass);
+}
+
+PROC _glBlendFuncSeparate = NULL;
+void glBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) {
+  _glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+}
+
+PROC _glGenFramebuffers = NULL;
+void glGenFramebuffers(GLsizei n, GLuint *framebuffers) { _glGenFramebuffers(n, framebuffers); }
+
+PROC _glDeleteFramebuffers = NULL;
+void glDeleteFramebuffers(GLsizei n, const GLuint *framebuffers) { _glDeleteFramebuffers(n, framebuffers); }
+
+PROC _glBindFramebuffer = NULL;
+void glBindFramebuffer(GLenum target, GLuint framebuffer) { _glBindFramebuffer(target, framebuffer); }
+
+PROC _glFramebufferTexture2D = NULL;
+void glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) {
+  _glFramebufferTexture2D(target, attachment, textarget, texture, level);
+}
+
+PROC _glCheckFramebufferStatus = NULL;
+GLenum glCheckFramebufferStatus(GLenum target) { return (GLenum) _glCheckFramebufferStatus(target); }
+
+PROC _glGenRenderbuffers = NULL;
+void glGenRenderbuffers(GLsizei n, GLuint *renderbuffers) { _glGenRenderbuffers(n, renderbuffers); }
+
+PROC _glDeleteRenderbuffers = NULL;
+void glDeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers) { _glDeleteRenderbuffers(n, renderbuffers); }
+
+PROC _glBindRenderbuffer = NULL;
+void glBindRenderbuffer(GLenum target, GLuint renderbuffer) { _glBindRenderbuffer(target, renderbuffer); }
+
+PROC _glRenderbufferStorage = NULL;
+void glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) {
+  _glRenderbufferStorage(target, internalformat, width, height);
+}
+
+PROC _glFramebufferRenderbuffer = NULL;
+void glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) {
+  _glFramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
+}
+
+PROC _glGenQueries = NULL;
+void glGenQueries(GLsizei n, GLuint *ids) { _glGenQueries(n, ids); }
+
+PROC _glDeleteQueries = NULL;
+void glDeleteQueries(GLsizei n, const GLuint *ids) { _glDeleteQueries(n, ids); }
+
+PROC _glBeginQuery = NULL;
+void glBeginQuery(GLenum target, GLuint id) { _glBeginQuery(target, id); }
+
+PROC _glEndQuery = NULL;
+void glEndQuery(GLenum target) { _glEndQuery(target); }
+
+PROC _glGetQueryObjectiv = NULL;
+void glGetQueryObjectiv(GLuint id, GLenum pname, GLint *params) { _glGetQueryObjectiv(id, pname, params); }
+
+PROC _glGetQueryObjectui64v = NULL;
+void glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64 *params) { _glGetQueryObjectui64v(id, pname, params); }
+
+PROC _glDeleteBuffers = NULL;
+void glDeleteBuffers(GLsizei n, const GLuint *buffers) { _glDeleteBuffers(n, buffers); }
+
+PROC _glMapBufferRange = NULL;
+void *glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+  return (void *) _glMapBufferRange(target, offset, length, access);
+}
+
+PROC _glUnmapBuffer = NULL;
+GLboolean glUnmapBuffer(GLenum target) { return (GLboolean) _glUnmapBuffer(target); }
+
+PROC _glFenceSync = NULL;
+GLsync glFenceSync(GLenum condition, GLbitfield flags) { return (GLsync) _glFenceSync(condition, flags); }
+
+PROC _glClientWaitSync = NULL;
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) { return (GLenum) _glClientWaitSync(sync, flags, timeout); }
+
+PROC _glDeleteSync = NULL;
+void glDeleteSync(GLsync sync) { _glDeleteSync(sync); }
+
+PROC _glUniform3fv = NULL;
+void glUniform3fv(GLint location, GLsizei count, const GLfloat *value) { _glUniform3fv(location, count, value); }
+
+PROC _glUniform4fv = NULL;
+void glUniform4fv(GLint location, GLsizei count, const GLfloat *value) { _glUniform4fv(location, count, value); }
+
+PROC _glUniformMatrix3fv = NULL;
+void glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) {
+  _glUniformMatrix3fv(location, count, transpose, value);
+}
+
 FRAME_DEF void frame_win32_opengl_init() {
   if(_glActiveTexture != NULL) {
     return;
@@ -1923,6 +7603,33 @@ FRAME_DEF void frame_win32_opengl_init() {
   _glUniform2fv= wglGetProcAddress("glUniform2fv");
   _glGetUniformiv= wglGetProcAddress("glGetUniformiv");
   _glCreateTextures = wglGetProcAddress("glCreateTextures");
+  _glStencilOpSeparate = wglGetProcAddress("glStencilOpSeparate");
+  _glBlendFuncSeparate = wglGetProcAddress("glBlendFuncSeparate");
+  _glGenFramebuffers = wglGetProcAddress("glGenFramebuffers");
+  _glDeleteFramebuffers = wglGetProcAddress("glDeleteFramebuffers");
+  _glBindFramebuffer = wglGetProcAddress("glBindFramebuffer");
+  _glFramebufferTexture2D = wglGetProcAddress("glFramebufferTexture2D");
+  _glCheckFramebufferStatus = wglGetProcAddress("glCheckFramebufferStatus");
+  _glGenRenderbuffers = wglGetProcAddress("glGenRenderbuffers");
+  _glDeleteRenderbuffers = wglGetProcAddress("glDeleteRenderbuffers");
+  _glBindRenderbuffer = wglGetProcAddress("glBindRenderbuffer");
+  _glRenderbufferStorage = wglGetProcAddress("glRenderbufferStorage");
+  _glFramebufferRenderbuffer = wglGetProcAddress("glFramebufferRenderbuffer");
+  _glGenQueries = wglGetProcAddress("glGenQueries");
+  _glDeleteQueries = wglGetProcAddress("glDeleteQueries");
+  _glBeginQuery = wglGetProcAddress("glBeginQuery");
+  _glEndQuery = wglGetProcAddress("glEndQuery");
+  _glGetQueryObjectiv = wglGetProcAddress("glGetQueryObjectiv");
+  _glGetQueryObjectui64v = wglGetProcAddress("glGetQueryObjectui64v");
+  _glDeleteBuffers = wglGetProcAddress("glDeleteBuffers");
+  _glMapBufferRange = wglGetProcAddress("glMapBufferRange");
+  _glUnmapBuffer = wglGetProcAddress("glUnmapBuffer");
+  _glFenceSync = wglGetProcAddress("glFenceSync");
+  _glClientWaitSync = wglGetProcAddress("glClientWaitSync");
+  _glDeleteSync = wglGetProcAddress("glDeleteSync");
+  _glUniform3fv = wglGetProcAddress("glUniform3fv");
+  _glUniform4fv = wglGetProcAddress("glUniform4fv");
+  _glUniformMatrix3fv = wglGetProcAddress("glUniformMatrix3fv");
   _wglSwapIntervalEXT = wglGetProcAddress("wglSwapIntervalEXT");
 }
 
@@ -0,0 +1,156 @@
+// Embed generator
+//   Writes a C header with an image decoded to rgba, or a font baked at a pixel
+//   height, so the program uploads it without decoding or baking at startup.
+//
+//   embed.exe <image> <out.h> <name>
+//   embed.exe <font.ttf> <out.h> <name> <pixel height>
+//
+//   embed.exe rsc\logo.jpg rsc\logo.h logo
+//
+//     #include "../rsc/logo.h"
+//     push_texture(LOGO_WIDTH, LOGO_HEIGHT, logo_data, false, &tex);
+//
+//   embed.exe C:\windows\Fonts\arial.ttf rsc\arial.h arial 64
+//
+//     #include "../rsc/arial.h"
+//     push_font_baked(arial_chars, arial_atlas, ARIAL_WIDTH, ARIAL_HEIGHT, ARIAL_PIXEL_HEIGHT, &font);
+
+#include "tools.h"
+
+#include <ctype.h>
+
+#define EMBED_BYTES_PER_LINE 16
+
+static void embed_bytes(FILE *f, const char *name, const char *suffix, const unsigned char *data, size_t size) {
+  fprintf(f, "static const unsigned char %s_%s[%zu] = {\n", name, suffix, size);
+  for(size_t i=0;i<size;i++) {
+    fprintf(f, "%s0x%02x,%s",
+	    i % EMBED_BYTES_PER_LINE == 0 ? "  " : "",
+	    data[i],
+	    (i % EMBED_BYTES_PER_LINE == EMBED_BYTES_PER_LINE - 1 || i == size - 1) ? "\n" : "");
+  }
+  fprintf(f, "};\n");
+}
+
+static void embed_begin(FILE *f, const char *upper, const char *source) {
+  fprintf(f, "// Generated by tools/embed.c from %s\n", source);
+  fprintf(f, "#ifndef %s_H\n", upper);
+  fprintf(f, "#define %s_H\n\n", upper);
+}
+
+static void embed_end(FILE *f, const char *upper) {
+  fprintf(f, "\n#endif //%s_H\n", upper);
+}
+
+static bool embed_image(FILE *f, const char *name, const char *upper, const char *source, unsigned char *data, size_t size) {
+  int width, height;
+  unsigned char *pixels = stbi_load_from_memory(data, (int) size, &width, &height, NULL, 4);
+  if(!pixels) {
+    fprintf(stderr, "ERROR: Can not decode image: %s\n", source);
+    return false;
+  }
+
+  embed_begin(f, upper, source);
+  fprintf(f, "#define %s_WIDTH %d\n", upper, width);
+  fprintf(f, "#define %s_HEIGHT %d\n\n", upper, height);
+  embed_bytes(f, name, "data", pixels, (size_t) width * height * 4);
+  embed_end(f, upper);
+
+  stbi_image_free(pixels);
+  return true;
+}
+
+static bool embed_font(FILE *f, const char *name, const char *upper, const char *source, unsigned char *data, float pixel_height) {
+  stbtt_bakedchar chars[96];
+  unsigned char *atlas = (unsigned char *) malloc(TOOLS_FONT_ATLAS_SIZE * TOOLS_FONT_ATLAS_SIZE);
+  if(!atlas) {
+    return false;
+  }
+
+  int rows = tools_bake_font(data, pixel_height, atlas, chars);
+  if(rows == 0) {
+    fprintf(stderr, "ERROR: Can not bake font: %s\n", source);
+    free(atlas);
+    return false;
+  }
+
+  embed_begin(f, upper, source);
+  fprintf(f, "#define %s_WIDTH %d\n", upper, TOOLS_FONT_ATLAS_SIZE);
+  fprintf(f, "#define %s_HEIGHT %d\n", upper, rows); // only the rows with glyphs
+  fprintf(f, "#define %s_PIXEL_HEIGHT %ff\n\n", upper, pixel_height);
+  embed_bytes(f, name, "chars", (const unsigned char *) chars, sizeof(chars));
+  fprintf(f, "\n");
+  embed_bytes(f, name, "atlas", atlas, (size_t) TOOLS_FONT_ATLAS_SIZE * rows);
+  embed_end(f, upper);
+
+  free(atlas);
+  return true;
+}
+
+int main(int argc, char **argv) {
+
+  if(argc != 4 && argc != 5) {
+    fprintf(stderr, "Usage: %s <image> <out.h> <name>\n", argv[0]);
+    fprintf(stderr, "       %s <font.ttf> <out.h> <name> <pixel height>\n", argv[0]);
+    return 1;
+  }
+  const char *source = argv[1];
+  const char *out = argv[2];
+  const char *name = argv[3];
+
+  char upper[64];
+  size_t len = strlen(name);
+  if(len == 0 || len >= sizeof(upper) || !(isalpha((unsigned char) name[0]) || name[0] == '_')) {
+    fprintf(stderr, "ERROR: Invalid name: %s\n", name);
+    return 1;
+  }
+  for(size_t i=0;i<=len;i++) {
+    if(name[i] && !(isalnum((unsigned char) name[i]) || name[i] == '_')) {
+      fprintf(stderr, "ERROR: Invalid name: %s\n", name);
+      return 1;
+    }
+    upper[i] = (char) toupper((unsigned char) name[i]);
+  }
+
+  float pixel_height = 0.0f;
+  if(argc == 5) {
+    pixel_height = (float) atof(argv[4]);
+    if(pixel_height <= 0.0f) {
+      fprintf(stderr, "ERROR: Invalid pixel height: %s\n", argv[4]);
+      return 1;
+    }
+  }
+
+  unsigned char *data;
+  size_t size;
+  if(!tools_read_file(source, &data, &size)) {
+    fprintf(stderr, "ERROR: Can not read file: %s\n", source);
+    return 1;
+  }
+  if(size == 0) {
+    fprintf(stderr, "ERROR: Empty file: %s\n", source);
+    free(data);
+    return 1;
+  }
+
+  FILE *f = fopen(out, "w");
+  if(!f) {
+    fprintf(stderr, "ERROR: Can not open file: %s\n", out);
+    free(data);
+    return 1;
+  }
+
+  bool ok = pixel_height > 0.0f
+    ? embed_font(f, name, upper, source, data, pixel_height)
+    : embed_image(f, name, upper, source, data, size);
+  if(fclose(f) != 0) {
+    ok = false;
+  }
+  free(data);
+
+  if(!ok) {
+    remove(out);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,237 @@
+// Asset packer
+//   Builds the pack opened by frame_renderer_pack_open from a directory. Images are
+//   decoded to rgba, fonts are kept as ttf and baked at every given pixel height,
+//   everything else is stored as it is.
+//
+//   pack.exe <dir> <out.pack> [pixel heights..]
+//   pack.exe rsc rsc.pack 32 64
+
+#include "tools.h"
+
+#define PACK_ENTRIES_CAP 1024
+#define PACK_HEIGHTS_CAP 16
+
+typedef char pack_chars_size_check[sizeof(stbtt_bakedchar) * 96 == FRAME_RENDERER_PACK_FONT_CHARS_SIZE ? 1 : -1];
+
+typedef struct{
+  Frame_Renderer_Pack_Entry entries[PACK_ENTRIES_CAP];
+  unsigned char *blobs[PACK_ENTRIES_CAP];
+  unsigned int entries_count;
+
+  float heights[PACK_HEIGHTS_CAP];
+  int heights_count;
+}Pack;
+
+static bool pack_has_extension(const char *name, const char **extensions) {
+  const char *dot = strrchr(name, '.');
+  if(!dot) {
+    return false;
+  }
+  for(;*extensions;extensions++) {
+    if(_stricmp(dot + 1, *extensions) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// takes the blob
+static bool pack_add(Pack *p, const char *name, Frame_Renderer_Pack_Kind kind, unsigned char *blob, size_t size) {
+  if(p->entries_count == PACK_ENTRIES_CAP) {
+    fprintf(stderr, "ERROR: More than %d entries\n", PACK_ENTRIES_CAP);
+    free(blob);
+    return false;
+  }
+  if(strlen(name) >= FRAME_RENDERER_PACK_NAME_CAP) {
+    fprintf(stderr, "ERROR: Name is too long: %s\n", name);
+    free(blob);
+    return false;
+  }
+
+  Frame_Renderer_Pack_Entry *e = &p->entries[p->entries_count];
+  memset(e, 0, sizeof(*e));
+  strcpy(e->name, name);
+  e->kind = (unsigned int) kind;
+  e->size = (unsigned long long) size;
+  p->blobs[p->entries_count++] = blob;
+  return true;
+}
+
+static bool pack_add_image(Pack *p, const char *name, unsigned char *data, size_t size) {
+  int width, height;
+  unsigned char *pixels = stbi_load_from_memory(data, (int) size, &width, &height, NULL, 4);
+  free(data);
+  if(!pixels) {
+    fprintf(stderr, "ERROR: Can not decode image: %s\n", name);
+    return false;
+  }
+
+  size_t bytes = (size_t) width * height * 4;
+  unsigned char *blob = (unsigned char *) malloc(bytes);
+  if(!blob) {
+    stbi_image_free(pixels);
+    return false;
+  }
+  memcpy(blob, pixels, bytes);
+  stbi_image_free(pixels);
+
+  if(!pack_add(p, name, FRAME_RENDERER_PACK_TEXTURE, blob, bytes)) {
+    return false;
+  }
+  p->entries[p->entries_count - 1].width = width;
+  p->entries[p->entries_count - 1].height = height;
+  return true;
+}
+
+static bool pack_add_font(Pack *p, const char *name, unsigned char *data, size_t size) {
+
+  for(int i=0;i<p->heights_count;i++) {
+    size_t bytes = FRAME_RENDERER_PACK_FONT_CHARS_SIZE + TOOLS_FONT_ATLAS_SIZE * TOOLS_FONT_ATLAS_SIZE;
+    unsigned char *blob = (unsigned char *) malloc(bytes);
+    if(!blob) {
+      free(data);
+      return false;
+    }
+
+    int rows = tools_bake_font(data, p->heights[i], blob + FRAME_RENDERER_PACK_FONT_CHARS_SIZE, (stbtt_bakedchar *) blob);
+    if(rows == 0) {
+      fprintf(stderr, "ERROR: Can not bake font: %s\n", name);
+      free(blob);
+      free(data);
+      return false;
+    }
+
+    // only the rows with glyphs are stored
+    if(!pack_add(p, name, FRAME_RENDERER_PACK_FONT, blob, FRAME_RENDERER_PACK_FONT_CHARS_SIZE + (size_t) TOOLS_FONT_ATLAS_SIZE * rows)) {
+      free(data);
+      return false;
+    }
+    Frame_Renderer_Pack_Entry *e = &p->entries[p->entries_count - 1];
+    e->width = TOOLS_FONT_ATLAS_SIZE;
+    e->height = rows;
+    e->pixel_height = p->heights[i];
+  }
+
+  // the ttf too, for the heights that were not baked
+  return pack_add(p, name, FRAME_RENDERER_PACK_FILE, data, size);
+}
+
+static bool pack_directory(Pack *p, const char *dir, const char *prefix) {
+  static const char *images[] = {"png", "jpg", "jpeg", "bmp", "tga", "gif", "psd", "hdr", "pic", "pnm", NULL};
+  static const char *fonts[] = {"ttf", "otf", NULL};
+
+  char path[MAX_PATH];
+  snprintf(path, sizeof(path), "%s\\*", dir);
+
+  WIN32_FIND_DATA data;
+  HANDLE handle = FindFirstFile(path, &data);
+  if(handle == INVALID_HANDLE_VALUE) {
+    fprintf(stderr, "ERROR: Can not open directory: %s\n", dir);
+    return false;
+  }
+
+  bool ok = true;
+  do {
+    if(strcmp(data.cFileName, ".") == 0 || strcmp(data.cFileName, "..") == 0) {
+      continue;
+    }
+
+    // names use '/', the pack is the same on every machine
+    char name[MAX_PATH];
+    snprintf(name, sizeof(name), "%s%s", prefix, data.cFileName);
+    snprintf(path, sizeof(path), "%s\\%s", dir, data.cFileName);
+
+    if(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+      char sub[MAX_PATH];
+      snprintf(sub, sizeof(sub), "%s/", name);
+      ok = pack_directory(p, path, sub);
+      continue;
+    }
+
+    unsigned char *file;
+    size_t size;
+    if(!tools_read_file(path, &file, &size)) {
+      fprintf(stderr, "ERROR: Can not read file: %s\n", path);
+      ok = false;
+    } else if(pack_has_extension(name, images)) {
+      ok = pack_add_image(p, name, file, size);
+    } else if(pack_has_extension(name, fonts)) {
+      ok = pack_add_font(p, name, file, size);
+    } else {
+      ok = pack_add(p, name, FRAME_RENDERER_PACK_FILE, file, size);
+    }
+  } while(ok && FindNextFile(handle, &data));
+
+  FindClose(handle);
+  return ok;
+}
+
+static bool pack_write(Pack *p, const char *path) {
+  FILE *f = fopen(path, "wb");
+  if(!f) {
+    fprintf(stderr, "ERROR: Can not open file: %s\n", path);
+    return false;
+  }
+
+  unsigned long long offset = sizeof(Frame_Renderer_Pack_Header) +
+    (unsigned long long) p->entries_count * sizeof(Frame_Renderer_Pack_Entry);
+  for(unsigned int i=0;i<p->entries_count;i++) {
+    offset = (offset + FRAME_RENDERER_PACK_ALIGNMENT - 1) & ~(unsigned long long) (FRAME_RENDERER_PACK_ALIGNMENT - 1);
+    p->entries[i].offset = offset;
+    offset += p->entries[i].size;
+  }
+
+  Frame_Renderer_Pack_Header header = {0};
+  header.magic = FRAME_RENDERER_PACK_MAGIC;
+  header.version = FRAME_RENDERER_PACK_VERSION;
+  header.entries_count = p->entries_count;
+
+  static const unsigned char zeros[FRAME_RENDERER_PACK_ALIGNMENT] = {0};
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+  ok = ok && fwrite(p->entries, sizeof(Frame_Renderer_Pack_Entry), p->entries_count, f) == p->entries_count;
+  for(unsigned int i=0;ok && i<p->entries_count;i++) {
+    size_t pad = (size_t) (p->entries[i].offset - (unsigned long long) ftell(f));
+    ok = fwrite(zeros, 1, pad, f) == pad;
+    ok = ok && fwrite(p->blobs[i], 1, (size_t) p->entries[i].size, f) == (size_t) p->entries[i].size;
+  }
+
+  if(fclose(f) != 0) {
+    ok = false;
+  }
+  if(!ok) {
+    fprintf(stderr, "ERROR: Can not write file: %s\n", path);
+  }
+  return ok;
+}
+
+int main(int argc, char **argv) {
+
+  if(argc < 3) {
+    fprintf(stderr, "Usage: %s <dir> <out.pack> [pixel heights..]\n", argv[0]);
+    return 1;
+  }
+
+  static Pack pack;
+  for(int i=3;i<argc && pack.heights_count<PACK_HEIGHTS_CAP;i++) {
+    float height = (float) atof(argv[i]);
+    if(height <= 0.0f) {
+      fprintf(stderr, "ERROR: Invalid pixel height: %s\n", argv[i]);
+      return 1;
+    }
+    pack.heights[pack.heights_count++] = height;
+  }
+
+  bool ok = pack_directory(&pack, argv[1], "") && pack_write(&pack, argv[2]);
+
+  unsigned long long bytes = 0;
+  for(unsigned int i=0;i<pack.entries_count;i++) {
+    bytes += pack.entries[i].size;
+    free(pack.blobs[i]);
+  }
+  if(!ok) {
+    return 1;
+  }
+
+  printf("%s: %u entries, %llu bytes\n", argv[2], pack.entries_count, bytes);
+  return 0;
+}
@@ -0,0 +1,60 @@
+#ifndef TOOLS_H
+#define TOOLS_H
+
+// Asset tools
+//   What pack.exe and embed.exe share: reading a whole source file and baking a font
+//   the way the renderer expects it.
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "../thirdparty/stb_truetype.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../thirdparty/stb_image.h"
+
+#define FRAME_STB_TRUETYPE
+#include "../src/frame.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TOOLS_FONT_ATLAS_SIZE 1024
+
+static bool tools_read_file(const char *path, unsigned char **data, size_t *size) {
+  FILE *f = fopen(path, "rb");
+  if(!f) {
+    return false;
+  }
+  fseek(f, 0, SEEK_END);
+  long len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  if(len < 0) {
+    fclose(f);
+    return false;
+  }
+
+  *data = (unsigned char *) malloc(len > 0 ? (size_t) len : 1);
+  if(!*data) {
+    fclose(f);
+    return false;
+  }
+  bool ok = fread(*data, 1, (size_t) len, f) == (size_t) len;
+  fclose(f);
+  if(!ok) {
+    free(*data);
+    return false;
+  }
+
+  *size = (size_t) len;
+  return true;
+}
+
+// ASCII 32..127 into an atlas TOOLS_FONT_ATLAS_SIZE square, returns the rows with glyphs
+// or 0 when they do not fit. The same glyph boxes as frame_renderer_glyph rasterizes.
+static int tools_bake_font(const unsigned char *ttf, float pixel_height, unsigned char *atlas, stbtt_bakedchar *chars) {
+  int rows = stbtt_BakeFontBitmap(ttf, 0, pixel_height, atlas, TOOLS_FONT_ATLAS_SIZE, TOOLS_FONT_ATLAS_SIZE,
+				  32, 96, chars);
+  return rows > 0 ? rows : 0;
+}
+
+#endif //TOOLS_H